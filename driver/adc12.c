@@ -45,6 +45,9 @@
 #include "adc12.h"
 #include "timer.h"
 
+// logic
+#include "profile.h"
+
 // *************************************************************************************************
 // Prototypes section
 
@@ -116,6 +119,8 @@ u16 adc12_single_conversion(u16 ref, u16 sht, u16 channel)
 #pragma vector=ADC12_VECTOR
 __interrupt void ADC12ISR(void)
 {
+    PROFILE_ENTER();
+
     switch (__even_in_range(ADC12IV, 34))
     {
         case 0:
@@ -160,5 +165,7 @@ __interrupt void ADC12ISR(void)
         default:
             break;
     }
+
+    PROFILE_EXIT(PROFILE_ADC12);
 }
 
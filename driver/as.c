@@ -45,6 +45,7 @@
 // driver
 #include "as.h"
 #include "timer.h"
+#include "power.h"
 
 
 // *************************************************************************************************
@@ -103,6 +104,7 @@ void as_start(void)
     AS_SPI_SEL |= AS_SDO_PIN + AS_SDI_PIN + AS_SCK_PIN; // Port pins to SDO, SDI and SCK function
     AS_CSN_OUT |= AS_CSN_PIN;                    // Deselect acceleration sensor
     AS_PWR_OUT |= AS_PWR_PIN;                    // Power on active high
+    power_on(POWER_ACCELERATION);
 
     // Delay of >5ms required between switching on power and configuring sensor
     Timer0_A4_Delay(CONV_MS_TO_TICKS(10));
@@ -125,6 +127,7 @@ void as_stop(void)
 
     // Power-down sensor
     AS_PWR_OUT &= ~AS_PWR_PIN;                   // Power off
+    power_off(POWER_ACCELERATION);
     AS_INT_OUT &= ~AS_INT_PIN;                   // Pin to low to avoid floating pins
     AS_SPI_OUT &= ~(AS_SDO_PIN + AS_SDI_PIN + AS_SCK_PIN); // Pins to low to avoid floating pins
     AS_SPI_SEL &= ~(AS_SDO_PIN + AS_SDI_PIN + AS_SCK_PIN); // Port pins to I/O function
@@ -45,6 +45,7 @@
 #include "buzzer.h"
 #include "timer.h"
 #include "display.h"
+#include "power.h"
 
 // logic
 #include "alarm.h"
@@ -116,6 +117,7 @@ void start_buzzer(u8 cycles, u16 on_time, u16 off_time)
 
         // Start with buzzer output on
         sBuzzer.state = BUZZER_ON_OUTPUT_ENABLED;
+        power_on(POWER_BUZZER);
     }
 }
 
@@ -139,6 +141,7 @@ void toggle_buzzer(void)
 
         // Update buzzer state
         sBuzzer.state = BUZZER_ON_OUTPUT_DISABLED;
+        power_off(POWER_BUZZER);
 
         // Reload Timer0_A4 IRQ to restart output
         sTimer.timer0_A3_ticks = sBuzzer.on_time;
@@ -160,6 +163,7 @@ void toggle_buzzer(void)
 
             // Update buzzer state
             sBuzzer.state = BUZZER_ON_OUTPUT_ENABLED;
+            power_on(POWER_BUZZER);
 
             // Reload Timer0_A4 IRQ to turn off output
             sTimer.timer0_A3_ticks = sBuzzer.off_time;
@@ -181,6 +185,7 @@ void stop_buzzer(void)
     // Disable buzzer PWM output
     P2OUT &= ~BIT7;
     P2SEL &= ~BIT7;
+    power_off(POWER_BUZZER);
 
     // Clear PWM timer interrupt
     TA1CCTL0 &= ~CCIE;
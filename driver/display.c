@@ -55,6 +55,7 @@
 // *************************************************************************************************
 // Prototypes section
 void write_lcd_mem(u8 * lcdmem, u8 bits, u8 bitmask, u8 state);
+void lcd_commit(void);
 void clear_line(u8 line);
 void display_symbol(u8 symbol, u8 mode);
 void display_char(u8 segment, u8 chr, u8 mode);
@@ -85,12 +86,12 @@ const u8 lcd_font[] = {
     0,                                                     // Displays " "
     SEG_D + SEG_E + SEG_G,                                 // Displays "c"
     0,                                                     // Displays " "
-    SEG_A + SEG_B + SEG_C + SEG_E + SEG_F + SEG_G,         // Displays "A"
-    SEG_C + SEG_D + SEG_E + SEG_F + SEG_G,                 // Displays "b"
-    SEG_A + SEG_D + SEG_E + SEG_F,                         // Displays "C"
-    SEG_B + SEG_C + SEG_D + SEG_E + SEG_G,                 // Displays "d"
-    SEG_A + +SEG_D + SEG_E + SEG_F + SEG_G,                // Displays "E"
-    SEG_A + SEG_E + SEG_F + SEG_G,                         // Displays "F"
+    LCD_GLYPH_A,                                           // Displays "A"
+    LCD_GLYPH_B,                                           // Displays "b"
+    LCD_GLYPH_C,                                           // Displays "C"
+    LCD_GLYPH_D,                                           // Displays "d"
+    LCD_GLYPH_E,                                           // Displays "E"
+    LCD_GLYPH_F,                                           // Displays "F"
     //  SEG_A+      SEG_C+SEG_D+SEG_E+SEG_F+SEG_G,       // Displays "G"
     SEG_A + SEG_B + SEG_C + SEG_D + SEG_F + SEG_G,         // Displays "g"
     SEG_B + SEG_C + SEG_E + SEG_F + SEG_G,                 // Displays "H"
@@ -98,20 +99,20 @@ const u8 lcd_font[] = {
     SEG_A + SEG_B + SEG_C + SEG_D,                         // Displays "J"
     //              SEG_B+SEG_C+      SEG_E+SEG_F+SEG_G,     // Displays "k"
     SEG_D + SEG_E + SEG_F + SEG_G,                         // Displays "k"
-    SEG_D + SEG_E + SEG_F,                                 // Displays "L"
+    LCD_GLYPH_L,                                           // Displays "L"
     SEG_A + SEG_B + SEG_C + SEG_E + SEG_F,                 // Displays "M"
-    SEG_C + SEG_E + SEG_G,                                 // Displays "n"
-    SEG_C + SEG_D + SEG_E + SEG_G,                         // Displays "o"
-    SEG_A + SEG_B + SEG_E + SEG_F + SEG_G,                 // Displays "P"
+    LCD_GLYPH_N,                                           // Displays "n"
+    LCD_GLYPH_O,                                           // Displays "o"
+    LCD_GLYPH_P,                                           // Displays "P"
     SEG_A + SEG_B + SEG_C + SEG_D + SEG_E + SEG_F,         // Displays "Q"
-    SEG_E + SEG_G,                                         // Displays "r"
-    SEG_A + SEG_C + SEG_D + SEG_F + SEG_G,                 // Displays "S"
-    SEG_D + SEG_E + SEG_F + SEG_G,                         // Displays "t"
+    LCD_GLYPH_R,                                           // Displays "r"
+    LCD_GLYPH_S,                                           // Displays "S"
+    LCD_GLYPH_T,                                           // Displays "t"
     SEG_C + SEG_D + SEG_E,                                 // Displays "u"
     SEG_C + SEG_D + SEG_E,                                 // Displays "u"
-    SEG_G,                                                 // Displays "-"
+    LCD_GLYPH_MINUS,                                       // Displays "-"
     SEG_B + SEG_C + +SEG_E + SEG_F + SEG_G,                // Displays "X"
-    SEG_B + SEG_C + SEG_D + SEG_F + SEG_G,                 // Displays "Y"
+    LCD_GLYPH_Y,                                           // Displays "Y"
     SEG_A + SEG_B + SEG_D + SEG_E + SEG_G,                 // Displays "Z"
 };
 
@@ -207,32 +208,46 @@ const u8 segments_bitmask[] = {
     LCD_SEG_L2_DP_MASK,
 };
 
-// Quick integer to array conversion table for most common integer values
-const u8 int_to_array_conversion_table[][3] = {
-    "000", "001", "002", "003", "004", "005", "006", "007", "008", "009", "010", "011", "012",
-    "013", "014", "015",
-    "016", "017", "018", "019", "020", "021", "022", "023", "024", "025", "026", "027", "028",
-    "029", "030", "031",
-    "032", "033", "034", "035", "036", "037", "038", "039", "040", "041", "042", "043", "044",
-    "045", "046", "047",
-    "048", "049", "050", "051", "052", "053", "054", "055", "056", "057", "058", "059", "060",
-    "061", "062", "063",
-    "064", "065", "066", "067", "068", "069", "070", "071", "072", "073", "074", "075", "076",
-    "077", "078", "079",
-    "080", "081", "082", "083", "084", "085", "086", "087", "088", "089", "090", "091", "092",
-    "093", "094", "095",
-    "096", "097", "098", "099", "100", "101", "102", "103", "104", "105", "106", "107", "108",
-    "109", "110", "111",
-    "112", "113", "114", "115", "116", "117", "118", "119", "120", "121", "122", "123", "124",
-    "125", "126", "127",
-    "128", "129", "130", "131", "132", "133", "134", "135", "136", "137", "138", "139", "140",
-    "141", "142", "143",
-    "144", "145", "146", "147", "148", "149", "150", "151", "152", "153", "154", "155", "156",
-    "157", "158", "159",
-    "160", "161", "162", "163", "164", "165", "166", "167", "168", "169", "170", "171", "172",
-    "173", "174", "175",
-    "176", "177", "178", "179", "180",
-};
+// Precompiled bitmaps for constant strings - skip font lookup and nibble swap at runtime
+const struct lcd_bitmap lcd_bmp_totp = { 4, {
+    LCD_BITMAP_L2(3, LCD_GLYPH_T), LCD_BITMAP_L2(2, LCD_GLYPH_O),
+    LCD_BITMAP_L2(1, LCD_GLYPH_T), LCD_BITMAP_L2(0, LCD_GLYPH_P),
+} };                                                       // "TOTP"
+
+const struct lcd_bitmap lcd_bmp_sync = { 5, {
+    LCD_BITMAP_L2_5_4(LCD_GLYPH_L2_5_BLANK, LCD_GLYPH_BLANK),
+    LCD_BITMAP_L2(3, LCD_GLYPH_S), LCD_BITMAP_L2(2, LCD_GLYPH_Y),
+    LCD_BITMAP_L2(1, LCD_GLYPH_N), LCD_BITMAP_L2(0, LCD_GLYPH_C),
+} };                                                       // "  SYNC"
+
+const struct lcd_bitmap lcd_bmp_done = { 5, {
+    LCD_BITMAP_L2_5_4(LCD_GLYPH_L2_5_BLANK, LCD_GLYPH_BLANK),
+    LCD_BITMAP_L2(3, LCD_GLYPH_D), LCD_BITMAP_L2(2, LCD_GLYPH_O),
+    LCD_BITMAP_L2(1, LCD_GLYPH_N), LCD_BITMAP_L2(0, LCD_GLYPH_E),
+} };                                                       // "  DONE"
+
+const struct lcd_bitmap lcd_bmp_acc = { 5, {
+    LCD_BITMAP_L2_5_4(LCD_GLYPH_L2_5_BLANK, LCD_GLYPH_BLANK),
+    LCD_BITMAP_L2(3, LCD_GLYPH_BLANK), LCD_BITMAP_L2(2, LCD_GLYPH_A),
+    LCD_BITMAP_L2(1, LCD_GLYPH_C), LCD_BITMAP_L2(0, LCD_GLYPH_C),
+} };                                                       // "   ACC"
+
+const struct lcd_bitmap lcd_bmp_rfbsl = { 5, {
+    LCD_BITMAP_L2_5_4(LCD_GLYPH_L2_5_BLANK, LCD_GLYPH_R),
+    LCD_BITMAP_L2(3, LCD_GLYPH_F), LCD_BITMAP_L2(2, LCD_GLYPH_B),
+    LCD_BITMAP_L2(1, LCD_GLYPH_S), LCD_BITMAP_L2(0, LCD_GLYPH_L),
+} };                                                       // " RFBSL"
+
+const struct lcd_bitmap lcd_bmp_lobatt = { 5, {
+    LCD_BITMAP_L2_5_4(LCD_GLYPH_L2_5_L, LCD_GLYPH_O),
+    LCD_BITMAP_L2(3, LCD_GLYPH_B), LCD_BITMAP_L2(2, LCD_GLYPH_A),
+    LCD_BITMAP_L2(1, LCD_GLYPH_T), LCD_BITMAP_L2(0, LCD_GLYPH_T),
+} };                                                       // "LOBATT"
+
+const struct lcd_bitmap lcd_bmp_l1_dashes = { 4, {
+    LCD_BITMAP_L1(3, LCD_GLYPH_MINUS), LCD_BITMAP_L1(2, LCD_GLYPH_MINUS),
+    LCD_BITMAP_L1(1, LCD_GLYPH_MINUS), LCD_BITMAP_L1(0, LCD_GLYPH_MINUS),
+} };                                                       // "----"
 
 // Display flags
 volatile s_display_flags display;
@@ -240,6 +255,14 @@ volatile s_display_flags display;
 // Global return string for int_to_array function
 u8 int_to_array_str[8];
 
+// RAM shadow of LCD memory and LCD blink memory
+u8 lcd_mem_shadow[LCD_MEM_SIZE];
+u8 lcd_blink_shadow[LCD_MEM_SIZE];
+
+// Bit n set = shadow byte n has not been written to LCD controller yet
+u16 lcd_mem_dirty;
+u16 lcd_blink_dirty;
+
 // *************************************************************************************************
 // Extern section
 extern void (*fptr_lcd_function_line1)(u8 line, u8 update);
@@ -255,6 +278,10 @@ void lcd_init(void)
 {
     // Clear entire display memory
     LCDBMEMCTL |= LCDCLRBM + LCDCLRM;
+    memset(lcd_mem_shadow, 0, LCD_MEM_SIZE);
+    memset(lcd_blink_shadow, 0, LCD_MEM_SIZE);
+    lcd_mem_dirty = 0;
+    lcd_blink_dirty = 0;
 
     // LCD_FREQ = ACLK/16/8 = 256Hz
     // Frame frequency = 256Hz/4 = 64Hz, LCD mux 4, LCD on
@@ -331,7 +358,8 @@ void clear_line(u8 line)
 
 // *************************************************************************************************
 // @fn          write_segment
-// @brief       Write to one or multiple LCD segments
+// @brief       Write to one or multiple LCD segments. Only the RAM shadow of LCD memory is
+//                              modified, lcd_commit() transfers changed bytes to the LCD controller.
 // @param       lcdmem          Pointer to LCD byte memory
 //                              bits            Segments to address
 //                              bitmask         Bitmask for particular display item
@@ -340,48 +368,145 @@ void clear_line(u8 line)
 // *************************************************************************************************
 void write_lcd_mem(u8 * lcdmem, u8 bits, u8 bitmask, u8 state)
 {
+    u8 index;
+    u8 mem, blink;
+
+    // Get shadow memory index from LCD memory address
+    index = (u8) (lcdmem - LCD_MEM_1);
+    mem = lcd_mem_shadow[index];
+    blink = lcd_blink_shadow[index];
+
     if (state == SEG_ON)
     {
         // Clear segments before writing
-        *lcdmem = (u8) (*lcdmem & ~bitmask);
+        mem = (u8) (mem & ~bitmask);
 
         // Set visible segments
-        *lcdmem = (u8) (*lcdmem | bits);
+        mem = (u8) (mem | bits);
     }
     else if (state == SEG_OFF)
     {
         // Clear segments
-        *lcdmem = (u8) (*lcdmem & ~bitmask);
+        mem = (u8) (mem & ~bitmask);
     }
     else if (state == SEG_ON_BLINK_ON)
     {
         // Clear visible / blink segments before writing
-        *lcdmem = (u8) (*lcdmem & ~bitmask);
-        *(lcdmem + 0x20) = (u8) (*(lcdmem + 0x20) & ~bitmask);
+        mem = (u8) (mem & ~bitmask);
+        blink = (u8) (blink & ~bitmask);
 
         // Set visible / blink segments
-        *lcdmem = (u8) (*lcdmem | bits);
-        *(lcdmem + 0x20) = (u8) (*(lcdmem + 0x20) | bits);
+        mem = (u8) (mem | bits);
+        blink = (u8) (blink | bits);
     }
     else if (state == SEG_ON_BLINK_OFF)
     {
         // Clear visible segments before writing
-        *lcdmem = (u8) (*lcdmem & ~bitmask);
+        mem = (u8) (mem & ~bitmask);
 
         // Set visible segments
-        *lcdmem = (u8) (*lcdmem | bits);
+        mem = (u8) (mem | bits);
 
         // Clear blink segments
-        *(lcdmem + 0x20) = (u8) (*(lcdmem + 0x20) & ~bitmask);
+        blink = (u8) (blink & ~bitmask);
     }
     else if (state == SEG_OFF_BLINK_OFF)
     {
         // Clear segments
-        *lcdmem = (u8) (*lcdmem & ~bitmask);
+        mem = (u8) (mem & ~bitmask);
 
         // Clear blink segments
-        *(lcdmem + 0x20) = (u8) (*(lcdmem + 0x20) & ~bitmask);
+        blink = (u8) (blink & ~bitmask);
+    }
+
+    // Mark bytes that differ from last committed content
+    if (mem != lcd_mem_shadow[index])
+    {
+        lcd_mem_shadow[index] = mem;
+        lcd_mem_dirty |= (1u << index);
+    }
+    if (blink != lcd_blink_shadow[index])
+    {
+        lcd_blink_shadow[index] = blink;
+        lcd_blink_dirty |= (1u << index);
+    }
+}
+
+// *************************************************************************************************
+// @fn          lcd_commit
+// @brief       Write changed bytes of LCD shadow memory and blink shadow memory to the LCD
+//                              controller. Called before CPU goes to low power mode.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void lcd_commit(void)
+{
+    u16 int_state;
+    u8 i;
+
+    // Nothing changed since last commit
+    if ((lcd_mem_dirty | lcd_blink_dirty) == 0)
+        return;
+
+    // Display routines are also called from ISRs - do not lose changes made during commit
+    // Caller may run with interrupts disabled (e.g. before entering LPM), keep them disabled
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+    for (i = 0; i < LCD_MEM_SIZE; i++)
+    {
+        if (lcd_mem_dirty & (1u << i))
+            *(LCD_MEM_1 + i) = lcd_mem_shadow[i];
+        if (lcd_blink_dirty & (1u << i))
+            *(LCD_MEM_1 + 0x20 + i) = lcd_blink_shadow[i];
     }
+    lcd_mem_dirty = 0;
+    lcd_blink_dirty = 0;
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          int_to_bcd
+// @brief       Convert integer to packed BCD (8 digits) by shift-add-3 (double dabble).
+//                              Needs no division, which is costly software routine on MSP430.
+//                              Digits above the 8th are dropped, result is n modulo 10^8.
+// @param       u32 n                   integer to convert
+// @return      u32                             8 BCD digits, least significant digit in bits 3..0
+// *************************************************************************************************
+u32 int_to_bcd(u32 n)
+{
+    u32 bcd = 0;
+    u32 adjust;
+    u8 bits = 32;
+
+    // Skip leading zero bits - most values are small
+    if ((n & 0xFFFF0000) == 0)
+    {
+        n <<= 16;
+        bits = 16;
+    }
+    if ((n & 0xFF000000) == 0)
+    {
+        n <<= 8;
+        bits -= 8;
+    }
+    while ((bits > 0) && ((n & 0x80000000) == 0))
+    {
+        n <<= 1;
+        bits--;
+    }
+
+    while (bits-- > 0)
+    {
+        // Add 3 to every BCD digit >= 5 (digit + 3 sets bit 3 of nibble exactly when digit >= 5)
+        adjust = (bcd + 0x33333333) & 0x88888888;
+        bcd += (adjust >> 2) + (adjust >> 3);
+
+        // Shift next binary bit into BCD value
+        bcd = (bcd << 1) | (n >> 31);
+        n <<= 1;
+    }
+
+    return (bcd);
 }
 
 // *************************************************************************************************
@@ -398,7 +523,7 @@ void write_lcd_mem(u8 * lcdmem, u8 bits, u8 bitmask, u8 state)
 u8 *int_to_array(u32 n, u8 digits, u8 blanks)
 {
     u8 i;
-    u8 digits1 = digits;
+    u32 bcd;
 
     // Preset result string
     memcpy(int_to_array_str, "0000000", 7);
@@ -407,32 +532,18 @@ u8 *int_to_array(u32 n, u8 digits, u8 blanks)
     if ((digits == 0) || (digits > 7))
         return (int_to_array_str);
 
-    // Numbers 0 .. 180 can be copied from int_to_array_conversion_table without conversion
-    if (n <= 180)
+    // Calculate digits from least to most significant number
+    bcd = int_to_bcd(n);
+    i = digits;
+    do
     {
-        if (digits >= 3)
-        {
-            memcpy(int_to_array_str + (digits - 3), int_to_array_conversion_table[n], 3);
-        }
-        else                    // digits == 1 || 2
-        {
-            memcpy(int_to_array_str, int_to_array_conversion_table[n] + (3 - digits), digits);
-        }
-    }
-    else                        // For n > 180 need to calculate string content
-    {
-        // Calculate digits from least to most significant number
-        do
-        {
-            int_to_array_str[digits - 1] = n % 10 + '0';
-            n /= 10;
-        }
-        while (--digits > 0);
+        int_to_array_str[--i] = (u8) (bcd & 0x0F) + '0';
+        bcd >>= 4;
     }
+    while (i > 0);
 
     // Remove specified number of leading '0', always keep last one
-    i = 0;
-    while ((int_to_array_str[i] == '0') && (i < digits1 - 1))
+    while ((int_to_array_str[i] == '0') && (i < digits - 1))
     {
         if (blanks > 0)
         {
@@ -691,6 +802,23 @@ void display_chars(u8 segments, u8 * str, u8 mode)
     }
 }
 
+// *************************************************************************************************
+// @fn          display_bitmap
+// @brief       Write precompiled string bitmap to LCD memory.
+// @param       const struct lcd_bitmap * bitmap        Bitmap, e.g. &lcd_bmp_sync
+//                              u8 mode             SEG_ON, SEG_OFF, SEG_BLINK
+// @return      none
+// *************************************************************************************************
+void display_bitmap(const struct lcd_bitmap *bitmap, u8 mode)
+{
+    u8 i;
+
+    for (i = 0; i < bitmap->length; i++)
+    {
+        write_lcd_mem(bitmap->byte[i].lcdmem, bitmap->byte[i].bits, bitmap->byte[i].bitmask, mode);
+    }
+}
+
 // *************************************************************************************************
 // @fn          switch_seg
 // @brief       Returns index of 7-segment character. Required for display routines that can draw
@@ -742,6 +870,8 @@ void stop_blink(void)
 // *************************************************************************************************
 void clear_blink_mem(void)
 {
+    memset(lcd_blink_shadow, 0, LCD_MEM_SIZE);
+    lcd_blink_dirty = 0;
     LCDBMEMCTL |= LCDCLRBM;
 }
 
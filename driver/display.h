@@ -48,7 +48,15 @@
 extern const u8 lcd_font[];
 extern const u8 *segments_lcdmem[];
 extern const u8 segments_bitmask[];
-extern const u8 int_to_array_conversion_table[][3];
+
+// Precompiled segment bitmaps for constant strings
+extern const struct lcd_bitmap lcd_bmp_totp;
+extern const struct lcd_bitmap lcd_bmp_sync;
+extern const struct lcd_bitmap lcd_bmp_done;
+extern const struct lcd_bitmap lcd_bmp_acc;
+extern const struct lcd_bitmap lcd_bmp_rfbsl;
+extern const struct lcd_bitmap lcd_bmp_lobatt;
+extern const struct lcd_bitmap lcd_bmp_l1_dashes;
 
 // *************************************************************************************************
 // Global Variable section
@@ -113,6 +121,31 @@ extern volatile s_display_flags display;
 #define SEG_F                   (BIT0)
 #define SEG_G                   (BIT1)
 
+// Font glyphs shared by lcd_font and the precompiled string bitmaps
+#define LCD_GLYPH_BLANK         (0)
+#define LCD_GLYPH_MINUS         (SEG_G)
+#define LCD_GLYPH_A             (SEG_A + SEG_B + SEG_C + SEG_E + SEG_F + SEG_G)
+#define LCD_GLYPH_B             (SEG_C + SEG_D + SEG_E + SEG_F + SEG_G)
+#define LCD_GLYPH_C             (SEG_A + SEG_D + SEG_E + SEG_F)
+#define LCD_GLYPH_D             (SEG_B + SEG_C + SEG_D + SEG_E + SEG_G)
+#define LCD_GLYPH_E             (SEG_A + SEG_D + SEG_E + SEG_F + SEG_G)
+#define LCD_GLYPH_F             (SEG_A + SEG_E + SEG_F + SEG_G)
+#define LCD_GLYPH_L             (SEG_D + SEG_E + SEG_F)
+#define LCD_GLYPH_N             (SEG_C + SEG_E + SEG_G)
+#define LCD_GLYPH_O             (SEG_C + SEG_D + SEG_E + SEG_G)
+#define LCD_GLYPH_P             (SEG_A + SEG_B + SEG_E + SEG_F + SEG_G)
+#define LCD_GLYPH_R             (SEG_E + SEG_G)
+#define LCD_GLYPH_S             (SEG_A + SEG_C + SEG_D + SEG_F + SEG_G)
+#define LCD_GLYPH_T             (SEG_D + SEG_E + SEG_F + SEG_G)
+#define LCD_GLYPH_Y             (SEG_B + SEG_C + SEG_D + SEG_F + SEG_G)
+
+// LINE2 characters have high- and low-nibble swapped against LINE1
+#define LCD_GLYPH_L2(glyph)     ((u8)((((glyph) << 4) & 0xF0) | (((glyph) >> 4) & 0x0F)))
+
+// Incomplete character LCD_SEG_L2_5 can only show '1' or 'L'
+#define LCD_GLYPH_L2_5_BLANK    (0)
+#define LCD_GLYPH_L2_5_L        (BIT7)
+
 // ------------------------------------------
 // LCD symbols for easier access
 //
@@ -211,6 +244,9 @@ extern volatile s_display_flags display;
 #define LCD_MEM_11                              ((u8*)0x0A2A)
 #define LCD_MEM_12                              ((u8*)0x0A2B)
 
+// Number of LCD memory bytes (LCD_MEM_1 .. LCD_MEM_12)
+#define LCD_MEM_SIZE                            (12u)
+
 // Memory assignment
 #define LCD_SEG_L1_0_MEM                        (LCD_MEM_6)
 #define LCD_SEG_L1_1_MEM                        (LCD_MEM_4)
@@ -299,12 +335,39 @@ extern volatile s_display_flags display;
 #define LCD_ICON_BEEPER2_MASK           (BIT3)
 #define LCD_ICON_BEEPER3_MASK           (BIT3)
 
+// Precompiled string bitmap - LCD memory bytes with bits and write mask, ready for write_lcd_mem
+#define LCD_BITMAP_MAX_BYTES                    (5u)
+
+struct lcd_bitmap_byte
+{
+    u8 *lcdmem;                 // LCD memory address
+    u8 bits;                    // Bits to set
+    u8 bitmask;                 // Bits to clear before writing
+};
+
+struct lcd_bitmap
+{
+    u8 length;                  // Number of used entries in byte[]
+    struct lcd_bitmap_byte byte[LCD_BITMAP_MAX_BYTES];
+};
+
+// Build bitmap entry for a single 7-segment character
+#define LCD_BITMAP_L1(seg, glyph)   { LCD_SEG_L1_##seg##_MEM, (glyph), LCD_SEG_L1_##seg##_MASK }
+#define LCD_BITMAP_L2(seg, glyph)   { LCD_SEG_L2_##seg##_MEM, LCD_GLYPH_L2(glyph), LCD_SEG_L2_##seg##_MASK }
+
+// LCD_SEG_L2_5 and LCD_SEG_L2_4 share one memory byte - write both characters at once
+#define LCD_BITMAP_L2_5_4(glyph5, glyph4)   { LCD_SEG_L2_4_MEM, (u8)((glyph5) | LCD_GLYPH_L2(glyph4)), \
+                                              LCD_SEG_L2_5_MASK + LCD_SEG_L2_4_MASK }
+
 // *************************************************************************************************
 // API section
 
-// Physical LCD memory write
+// LCD shadow memory write
 extern void write_lcd_mem(u8 * lcdmem, u8 bits, u8 bitmask, u8 state);
 
+// Physical LCD memory write of changed shadow bytes
+extern void lcd_commit(void);
+
 // Display init / clear
 extern void lcd_init(void);
 extern void clear_display(void);
@@ -321,6 +384,7 @@ extern void set_blink_rate(u8 bits);
 extern void display_char(u8 segment, u8 chr, u8 mode);
 extern void display_chars(u8 segments, u8 * str, u8 mode);
 extern void display_symbol(u8 symbol, u8 mode);
+extern void display_bitmap(const struct lcd_bitmap *bitmap, u8 mode);
 
 // Time display function
 extern void DisplayTime(u8 updateMode);
@@ -331,6 +395,7 @@ extern void display_value(u8 segments, u32 value, u8 digits, u8 blanks);
 extern void display_hours(u8 segments, u32 value, u8 digits, u8 blanks);
 
 // Integer to string conversion
+extern u32 int_to_bcd(u32 n);
 extern u8 *int_to_array(u32 n, u8 digits, u8 blanks);
 
 // Segment index helper function
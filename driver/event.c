@@ -0,0 +1,130 @@
+// *************************************************************************************************
+// Event queue. ISRs post events, main loop gets and processes them.
+// *************************************************************************************************
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// driver
+#include "event.h"
+
+// *************************************************************************************************
+// Prototypes section
+void event_init(void);
+void event_post(u8 type, u8 param);
+u8 event_get(struct event *ev);
+u8 event_pending(void);
+
+// *************************************************************************************************
+// Defines section
+
+// *************************************************************************************************
+// Global Variable section
+struct event_queue sEvent;
+
+// *************************************************************************************************
+// Extern section
+
+// *************************************************************************************************
+// @fn          event_init
+// @brief       Empty event queue.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void event_init(void)
+{
+    sEvent.head = 0;
+    sEvent.tail = 0;
+    sEvent.queued = 0;
+}
+
+// *************************************************************************************************
+// @fn          event_post
+// @brief       Append event to queue. An event that is already queued is not queued again -
+//                              it is processed with the latest data anyway. Its parameter is
+//                              replaced, so the latest post decides (e.g. number of buzzer
+//                              signals). Can be called with interrupts enabled, so posting is
+//                              protected against interrupts.
+// @param       u8 type                 Event type EVENT_xxx
+//                              u8 param                Event parameter
+// @return      none
+// *************************************************************************************************
+void event_post(u8 type, u8 param)
+{
+    u16 int_state;
+    u16 mask = 1u << type;
+    u8 head;
+    u8 i;
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    if ((sEvent.queued & mask) == 0)
+    {
+        head = sEvent.head;
+        sEvent.event[head].type = type;
+        sEvent.event[head].param = param;
+        sEvent.queued |= mask;
+
+        // Publish event after it has been written
+        sEvent.head = (head + 1) & (EVENT_QUEUE_SIZE - 1);
+    }
+    else
+    {
+        // Update parameter of queued event
+        for (i = sEvent.tail; i != sEvent.head; i = (i + 1) & (EVENT_QUEUE_SIZE - 1))
+        {
+            if (sEvent.event[i].type == type)
+            {
+                sEvent.event[i].param = param;
+                break;
+            }
+        }
+    }
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          event_get
+// @brief       Remove oldest event from queue. Called by main loop only. Interrupts are locked
+//                              while the event is removed, so event_post() cannot update the
+//                              parameter of an event that was already taken.
+// @param       struct event *ev        Oldest event
+// @return      u8                      1 = event returned, 0 = queue empty
+// *************************************************************************************************
+u8 event_get(struct event *ev)
+{
+    u16 int_state;
+    u8 tail = sEvent.tail;
+
+    if (tail == sEvent.head)
+        return (0);
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    *ev = sEvent.event[tail];
+    sEvent.tail = (tail + 1) & (EVENT_QUEUE_SIZE - 1);
+
+    // Same event can be queued again while this one is processed
+    sEvent.queued &= ~(1u << ev->type);
+
+    __set_interrupt_state(int_state);
+
+    return (1);
+}
+
+// *************************************************************************************************
+// @fn          event_pending
+// @brief       Check if any event is queued.
+// @param       none
+// @return      u8                      1 = queue not empty, 0 = queue empty
+// *************************************************************************************************
+u8 event_pending(void)
+{
+    return (sEvent.tail != sEvent.head);
+}
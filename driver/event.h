@@ -0,0 +1,66 @@
+// *************************************************************************************************
+// Event queue interface.
+// *************************************************************************************************
+
+#ifndef EVENT_H_
+#define EVENT_H_
+
+// *************************************************************************************************
+// Include section
+
+// *************************************************************************************************
+// Prototypes section
+extern void event_init(void);
+extern void event_post(u8 type, u8 param);
+extern u8 event_pending(void);
+
+// *************************************************************************************************
+// Defines section
+
+// Event types, processed by main loop outside ISR context. Type is index into event_handler[].
+// A type is queued only once, posting it again replaces the parameter of the queued event.
+#define EVENT_TEMPERATURE_MEASUREMENT   (0u)    // param: FILTER_ON, FILTER_OFF
+#define EVENT_VOLTAGE_MEASUREMENT       (1u)
+#define EVENT_ALTITUDE_MEASUREMENT      (2u)    // param: FILTER_ON, FILTER_OFF
+#define EVENT_ACCELERATION_MEASUREMENT  (3u)
+#define EVENT_BUZZER                    (4u)    // param: number of buzzer signals, latest wins
+#define EVENT_COUNTER_MEASUREMENT       (5u)
+#define EVENT_LOGGER                    (6u)
+#define EVENT_ALTITUDE_SESSION          (7u)
+#define EVENT_TYPES                     (8u)
+
+// Queue size (power of 2, larger than EVENT_TYPES). Each type is queued at most once, so queue
+// never overflows.
+#define EVENT_QUEUE_SIZE                (16u)
+
+struct event
+{
+    u8 type;
+    u8 param;
+};
+
+struct event_queue
+{
+    struct event event[EVENT_QUEUE_SIZE];
+
+    // Next free slot - written by event_post() only
+    volatile u8 head;
+
+    // Oldest queued event - written by event_get() only, read by event_post() to update a queued
+    // event
+    volatile u8 tail;
+
+    // Bit n set = event type n is queued
+    volatile u16 queued;
+};
+
+extern u8 event_get(struct event *ev);
+
+// *************************************************************************************************
+// Global Variable section
+extern struct event_queue sEvent;
+
+// *************************************************************************************************
+// Extern section
+
+#endif                          /*EVENT_H_ */
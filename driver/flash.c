@@ -0,0 +1,86 @@
+// *************************************************************************************************
+// Flash memory driver. Erases and writes info or main flash segments.
+// *************************************************************************************************
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// driver
+#include "flash.h"
+
+// *************************************************************************************************
+// Prototypes section
+void flash_erase(u8 * ptr);
+void flash_write(u8 * ptr, const u8 * data, u16 length);
+
+// *************************************************************************************************
+// Defines section
+
+// *************************************************************************************************
+// Global Variable section
+
+// *************************************************************************************************
+// Extern section
+
+// *************************************************************************************************
+// @fn          flash_erase
+// @brief       Erase flash segment. CPU is held until erase has finished (~30ms).
+// @param       u8 * ptr                Any address inside segment
+// @return      none
+// *************************************************************************************************
+void flash_erase(u8 * ptr)
+{
+    u16 int_state;
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    // Unlock flash and select segment erase
+    FCTL3 = FWKEY;
+    FCTL1 = FWKEY + ERASE;
+
+    // Dummy write starts erase
+    *ptr = 0;
+    while (FCTL3 & BUSY) ;
+
+    // Lock flash
+    FCTL1 = FWKEY;
+    FCTL3 = FWKEY + LOCK;
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          flash_write
+// @brief       Write bytes to erased flash. Bits can only be cleared, erase segment before.
+// @param       u8 * ptr                Flash destination address
+//                              const u8 * data         Source data
+//                              u16 length              Number of bytes
+// @return      none
+// *************************************************************************************************
+void flash_write(u8 * ptr, const u8 * data, u16 length)
+{
+    u16 int_state;
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    // Unlock flash and select byte write
+    FCTL3 = FWKEY;
+    FCTL1 = FWKEY + WRT;
+
+    while (length--)
+    {
+        *ptr++ = *data++;
+        while (FCTL3 & BUSY) ;
+    }
+
+    // Lock flash
+    FCTL1 = FWKEY;
+    FCTL3 = FWKEY + LOCK;
+
+    __set_interrupt_state(int_state);
+}
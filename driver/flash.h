@@ -0,0 +1,38 @@
+// *************************************************************************************************
+// Flash memory driver interface.
+// *************************************************************************************************
+
+#ifndef FLASH_H_
+#define FLASH_H_
+
+// *************************************************************************************************
+// Include section
+
+// *************************************************************************************************
+// Prototypes section
+extern void flash_erase(u8 * ptr);
+extern void flash_write(u8 * ptr, const u8 * data, u16 length);
+
+// *************************************************************************************************
+// Defines section
+
+// Segment sizes (bytes)
+#define FLASH_INFO_SEGMENT_SIZE         (128u)
+#define FLASH_MAIN_SEGMENT_SIZE         (512u)
+
+// Info memory segments. Segment D holds the factory calibration data read by
+// read_calibration_values() and is never written. Segment A is protected by LOCKA and not used.
+#define FLASH_INFO_D                    ((u8 *) 0x1800)
+#define FLASH_INFO_C                    ((u8 *) 0x1880)
+#define FLASH_INFO_B                    ((u8 *) 0x1900)
+
+// Value of erased flash byte
+#define FLASH_ERASED                    (0xFFu)
+
+// *************************************************************************************************
+// Global Variable section
+
+// *************************************************************************************************
+// Extern section
+
+#endif                          /*FLASH_H_ */
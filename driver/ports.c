@@ -51,6 +51,8 @@
 #include "cma_ps.h"
 #include "ps.h"
 #include "timer.h"
+#include "event.h"
+#include "power.h"
 #include "display.h"
 
 // logic
@@ -62,12 +64,15 @@
 #include "stopwatch.h"
 #include "acceleration.h"
 #include "counter.h"
+#include "profile.h"
 
 // *************************************************************************************************
 // Prototypes section
 void button_repeat_on(u16 msec);
 void button_repeat_off(void);
-void button_repeat_function(void);
+void tick_backlight(void);
+u8 button_sample(void);
+void button_lock_toggle(void);
 
 // *************************************************************************************************
 // Defines section
@@ -82,7 +87,7 @@ volatile struct struct_button sButton;
 
 // *************************************************************************************************
 // Extern section
-extern void (*fptr_Timer0_A3_function)(void);
+extern void tick_message(void);
 
 // *************************************************************************************************
 // @fn          init_buttons
@@ -121,29 +126,26 @@ void init_buttons(void)
 #pragma vector=PORT2_VECTOR
 __interrupt void PORT2_ISR(void)
 {
-    // Clear flags
-    u8 int_flag, int_enable;
-    u8 buzzer = 0;
+    u8 int_flag;
     u8 simpliciti_button_event = 0;
     static u8 simpliciti_button_repeat = 0;
+    PROFILE_ENTER();
 
-    // Remember interrupt enable bits
-    int_enable = BUTTONS_IE;
+    // Store valid interrupt flags
+    int_flag = BUTTONS_IFG & BUTTONS_IE;
+    BUTTONS_IFG &= ~int_flag;
 
     if ((!button.flag.star_long) && (!button.flag.num_long))
     {
-        // Clear button flags
-        button.all_flags = 0;
-
-        // Store valid button interrupt flag
-        int_flag = BUTTONS_IFG & int_enable;
-
         // ---------------------------------------------------
         // While SimpliciTI stack is active, buttons behave differently:
         //  - Store button events in SimpliciTI packet data
         //  - Exit SimpliciTI when button DOWN was pressed
         if (is_rf())
         {
+            // Clear button flags
+            button.all_flags = 0;
+
             // Erase previous button press after a number of resends (increase number if link
             // quality is low)
             // This will create a series of packets containing the same button press
@@ -179,287 +181,328 @@ __interrupt void PORT2_ISR(void)
             if (simpliciti_button_event)
                 simpliciti_flag |= SIMPLICITI_TRIGGER_SEND_DATA;
         }
-        else                    // Normal operation
+        else if ((int_flag & ALL_BUTTONS) != 0)     // Normal operation
         {
-            // Debounce buttons
-            if ((int_flag & ALL_BUTTONS) != 0)
-            {
-                // Disable PORT2 IRQ
-                __disable_interrupt();
-                BUTTONS_IE = 0x00;
-                __enable_interrupt();
+            // Clear button flags
+            button.all_flags = 0;
 
-                // Debounce delay 1
-                Timer0_A4_Delay(CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_IN));
+            // Reset inactivity detection
+            sTime.last_activity = sTime.system_time;
 
-                // Reset inactivity detection
-                sTime.last_activity = sTime.system_time;
-            }
+            // Test mode stops Timer0 while it waits for a button press - start it again, else
+            // the press would be dropped
+            if ((TA0CTL & (BIT4 | BIT5)) == 0)
+                Timer0_Start();
 
-            // ---------------------------------------------------
-            // STAR button IRQ
-            if (IRQ_TRIGGERED(int_flag, BUTTON_STAR_PIN))
-            {
-                // Filter bouncing noise
-                if (BUTTON_STAR_IS_PRESSED)
-                {
-                    button.flag.star = 1;
-                    button.flag.star_not_long = 0;
-                    // Generate button click
-                    buzzer = 1;
-                }
-                else if ((BUTTONS_IES & BUTTON_STAR_PIN) == BUTTON_STAR_PIN)
-                {
-                    button.flag.star = 1;
-                    button.flag.star_not_long = 0;
-                    BUTTONS_IES &= ~BUTTON_STAR_PIN;
-                }
-            }
-            // ---------------------------------------------------
-            // NUM button IRQ
-            else if (IRQ_TRIGGERED(int_flag, BUTTON_NUM_PIN))
-            {
-                // Filter bouncing noise
-                if (BUTTON_NUM_IS_PRESSED)
-                {
-                    button.flag.num = 1;
-                    button.flag.num_not_long = 0;
-                    // Generate button click
-                    buzzer = 1;
-                }
-                else if ((BUTTONS_IES & BUTTON_NUM_PIN) == BUTTON_NUM_PIN)
-                {
-                    button.flag.num = 1;
-                    button.flag.num_not_long = 0;
-                    BUTTONS_IES &= ~BUTTON_NUM_PIN;
-                }
-            }
-            // ---------------------------------------------------
-            // UP button IRQ
-            else if (IRQ_TRIGGERED(int_flag, BUTTON_UP_PIN))
-            {
-                // Filter bouncing noise
-                if (BUTTON_UP_IS_PRESSED)
-                {
-                    button.flag.up = 1;
-
-                    // Generate button click
-                    buzzer = 1;
-                }
-            }
-            // ---------------------------------------------------
-            // DOWN button IRQ
-            else if (IRQ_TRIGGERED(int_flag, BUTTON_DOWN_PIN))
-            {
-                // Filter bouncing noise
-                if (BUTTON_DOWN_IS_PRESSED)
-                {
-                    button.flag.down = 1;
-
-                    // Generate button click
-                    buzzer = 1;
-
-                    // Faster reaction for stopwatch stop button press
-                    if (is_stopwatch() && !sys.flag.lock_buttons)
-                    {
-                        stop_stopwatch();
-                        button.flag.down = 0;
-                    }
-                }
-            }
-            // ---------------------------------------------------
-            // B/L button IRQ
-            else if (IRQ_TRIGGERED(int_flag, BUTTON_BACKLIGHT_PIN))
-            {
-                // Filter bouncing noise
-                if (BUTTON_BACKLIGHT_IS_PRESSED)
-                {
-                    sButton.backlight_status = 1;
-                    sButton.backlight_timeout = 0;
-                    P2OUT |= BUTTON_BACKLIGHT_PIN;
-                    P2DIR |= BUTTON_BACKLIGHT_PIN;
-                }
-            }
+            // Sample buttons with Timer0_A0 until all buttons are released
+            // Button IRQs are not needed meanwhile - sensor IRQs stay enabled
+            sButton.sample_ie = BUTTONS_IE & ALL_BUTTONS;
+            BUTTONS_IE &= ~ALL_BUTTONS;
+            Timer0_A0_Start(CONV_MS_TO_TICKS(BUTTONS_SAMPLE_TIME));
         }
+    }
+
+    // ---------------------------------------------------
+    // Acceleration sensor IRQ
+    if (IRQ_TRIGGERED(int_flag, AS_INT_PIN))
+    {
+    	  // Get data from sensor
+    	  if ( is_acceleration_measurement())
+    	     event_post(EVENT_ACCELERATION_MEASUREMENT, 0);
+    	  if ( is_counter_measurement()) {
+    	     event_post(EVENT_COUNTER_MEASUREMENT, 0);
+    	  }
+    }
+
+    // ---------------------------------------------------
+    // Pressure sensor IRQ
+    if (IRQ_TRIGGERED(int_flag, PS_INT_PIN))
+    {
+        // Get data from sensor
+        event_post(EVENT_ALTITUDE_MEASUREMENT, FILTER_ON);
+    }
+
+    PROFILE_EXIT(PROFILE_PORT2);
+
+    // Exit from LPM3/LPM4 on RETI
+    __bic_SR_register_on_exit(LPM4_bits);
+}
+
+// *************************************************************************************************
+// @fn          button_sample
+// @brief       Button gesture detection. Called by TIMER0_A0_ISR every BUTTONS_SAMPLE_TIME while
+//                              a button is pressed. Sets button flags for
+//                                      - short press (UP / DOWN when pressed, STAR / NUM when
+//                                        released)
+//                                      - long STAR / NUM press
+//                                      - double STAR / NUM press
+//                                      - NUM + DOWN chord (button lock)
+//                                      - accelerating UP / DOWN auto repeat (set_value only)
+//                              Enables button IRQs again when all buttons are released.
+// @param       none
+// @return      u8              1 = new button event, wake up main loop
+// *************************************************************************************************
+u8 button_sample(void)
+{
+    u16 flags = button.all_flags;
+    u8 raw = BUTTONS_IN & ALL_BUTTONS;
+    u8 pins = sButton.pins;
+    u8 pressed, released;
+
+    // Filter bouncing noise - accept new button state when two samples are equal
+    if (raw == sButton.sample)
+        pins = raw;
+    sButton.sample = raw;
+    pressed = pins & ~sButton.pins;
+    released = sButton.pins & ~pins;
+    sButton.pins = pins;
+
+    // Time out double press detection
+    if (sButton.star_gap)
+        sButton.star_gap--;
+    if (sButton.num_gap)
+        sButton.num_gap--;
+
+    // ---------------------------------------------------
+    // Button presses
+    if ((pressed & BUTTON_STAR_PIN) == BUTTON_STAR_PIN)
+    {
+        sButton.star_hold = 1;
+    }
+    if ((pressed & BUTTON_NUM_PIN) == BUTTON_NUM_PIN)
+    {
+        sButton.num_hold = 1;
+    }
+    if ((pressed & (BUTTON_NUM_PIN | BUTTON_DOWN_PIN)) != 0 &&
+        (pins & (BUTTON_NUM_PIN | BUTTON_DOWN_PIN)) == (BUTTON_NUM_PIN | BUTTON_DOWN_PIN))
+    {
+        // Trying to lock/unlock buttons - no NUM / DOWN button event and no button click
+        sButton.chord_hold = 1;
+        sButton.num_hold = 0;
+        pressed &= ~(BUTTON_NUM_PIN | BUTTON_DOWN_PIN);
+    }
+    if ((pressed & BUTTON_UP_PIN) == BUTTON_UP_PIN)
+    {
+        button.flag.up = 1;
+    }
+    if ((pressed & BUTTON_DOWN_PIN) == BUTTON_DOWN_PIN)
+    {
+        button.flag.down = 1;
 
-        // Trying to lock/unlock buttons?
-        if (button.flag.num && button.flag.down)
+        // Faster reaction for stopwatch stop button press
+        if (is_stopwatch() && !sys.flag.lock_buttons)
         {
-            // No buzzer output
-            buzzer = 0;
-            button.all_flags = 0;
+            stop_stopwatch();
+            button.flag.down = 0;
         }
+    }
+    if ((pressed & (BUTTON_UP_PIN | BUTTON_DOWN_PIN)) != 0)
+    {
+        // Restart auto repeat
+        sButton.repeats = 0;
+        sButton.repeat_period = sButton.repeat_time;
+        sButton.repeat_next = CONV_MS_TO_SAMPLES(BUTTONS_REPEAT_DELAY);
+    }
+    if ((pressed & BUTTON_BACKLIGHT_PIN) == BUTTON_BACKLIGHT_PIN)
+    {
+        sButton.backlight_status = 1;
+        P2OUT |= BUTTON_BACKLIGHT_PIN;
+        P2DIR |= BUTTON_BACKLIGHT_PIN;
+        power_on(POWER_BACKLIGHT);
+
+        // Turn backlight off after timeout, restart timeout if already on
+        timer_job_start(TIMER_JOB_BACKLIGHT, tick_backlight, BACKLIGHT_TIME_ON + 1,
+                        TIMER_JOB_ONE_SHOT);
+    }
 
-        // Generate button click when button was activated
-        if (buzzer)
+    // Generate button click when button was activated
+    if ((pressed & (ALL_BUTTONS & ~BUTTON_BACKLIGHT_PIN)) != 0)
+    {
+        // Any button event stops active alarm
+        if (sAlarm.state == ALARM_ON)
         {
-            // Any button event stops active alarm
-            if (sAlarm.state == ALARM_ON)
-            {
-                stop_alarm();
-                button.all_flags = 0;
-            }
-            else if (!sys.flag.up_down_repeat_enabled)
-            {
-                start_buzzer(1, CONV_MS_TO_TICKS(20), CONV_MS_TO_TICKS(150));
-            }
-
-            // Debounce delay 2
-            Timer0_A4_Delay(CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_OUT));
+            stop_alarm();
+            button.all_flags = 0;
+            sButton.star_hold = 0;
+            sButton.num_hold = 0;
         }
-
-        // ---------------------------------------------------
-        // Acceleration sensor IRQ
-        if (IRQ_TRIGGERED(int_flag, AS_INT_PIN))
+        else if (!sys.flag.up_down_repeat_enabled)
         {
-        	  // Get data from sensor
-        	  if ( is_acceleration_measurement())
-        	     request.flag.acceleration_measurement = 1;
-        	  if ( is_counter_measurement()) {
-        	     request.flag.counter_measurement = 1;
-        	  }
+            start_buzzer(1, CONV_MS_TO_TICKS(20), CONV_MS_TO_TICKS(150));
         }
+    }
 
-        // ---------------------------------------------------
-        // Pressure sensor IRQ
-        if (IRQ_TRIGGERED(int_flag, PS_INT_PIN))
+    // ---------------------------------------------------
+    // Buttons held
+    if ((pins & (BUTTON_NUM_PIN | BUTTON_DOWN_PIN)) != (BUTTON_NUM_PIN | BUTTON_DOWN_PIN))
+    {
+        sButton.chord_hold = 0;
+    }
+    else if (sButton.chord_hold && (++sButton.chord_hold > CONV_MS_TO_SAMPLES(BUTTONS_CHORD_TIME)))
+    {
+        button_lock_toggle();
+        sButton.chord_hold = 0;
+    }
+
+    if ((pins & BUTTON_STAR_PIN) && sButton.star_hold &&
+        (++sButton.star_hold > CONV_MS_TO_SAMPLES(BUTTONS_LONG_TIME)))
+    {
+        button.flag.star_long = 1;
+        sButton.star_hold = 0;
+    }
+    if ((pins & BUTTON_NUM_PIN) && sButton.num_hold &&
+        (++sButton.num_hold > CONV_MS_TO_SAMPLES(BUTTONS_LONG_TIME)))
+    {
+        button.flag.num_long = 1;
+        sButton.num_hold = 0;
+    }
+
+    // While in set_value(), create virtual UP/DOWN button events with increasing rate
+    if (sys.flag.up_down_repeat_enabled && ((pins & (BUTTON_UP_PIN | BUTTON_DOWN_PIN)) != 0) &&
+        sButton.repeat_next && (--sButton.repeat_next == 0))
+    {
+        if ((pins & BUTTON_UP_PIN) == BUTTON_UP_PIN)
+            button.flag.up = 1;
+        else
+            button.flag.down = 1;
+
+        // Increase repeat counter
+        sButton.repeats++;
+
+        // Accelerate auto repeat
+        if (sButton.repeat_period > CONV_MS_TO_SAMPLES(BUTTONS_REPEAT_TIME_MIN))
+            sButton.repeat_period--;
+        sButton.repeat_next = sButton.repeat_period;
+
+        // Reset inactivity detection counter
+        sTime.last_activity = sTime.system_time;
+
+        // Disable blinking
+        stop_blink();
+    }
+
+    // ---------------------------------------------------
+    // Button releases
+    if ((released & BUTTON_STAR_PIN) == BUTTON_STAR_PIN)
+    {
+        // Short press when released before long press time
+        if (sButton.star_hold)
         {
-            // Get data from sensor
-            request.flag.altitude_measurement = 1;
+            button.flag.star = 1;
+            if (sButton.star_gap)
+            {
+                button.flag.star_double = 1;
+                sButton.star_gap = 0;
+            }
+            else
+            {
+                sButton.star_gap = CONV_MS_TO_SAMPLES(BUTTONS_DOUBLE_TIME);
+            }
         }
-
-        // ---------------------------------------------------
-        // Safe long button event detection
-        if (button.flag.star || button.flag.num)
+        sButton.star_hold = 0;
+    }
+    if ((released & BUTTON_NUM_PIN) == BUTTON_NUM_PIN)
+    {
+        // Short press when released before long press time
+        if (sButton.num_hold)
         {
-            // Additional debounce delay to enable safe high detection - 50ms
-            Timer0_A4_Delay(CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_LEFT));
-
-            // Check if this button event is short enough
-            if (BUTTON_STAR_IS_PRESSED)
+            button.flag.num = 1;
+            if (sButton.num_gap)
             {
-                // Change interrupt edge to detect button release
-                BUTTONS_IES |= BUTTON_STAR_PIN;
-                button.flag.star = 0;
-                // This flag is used to detect if the user released the button before the
-                // time for a long button press (3s)
-                button.flag.star_not_long = 1;
+                button.flag.num_double = 1;
+                sButton.num_gap = 0;
             }
-            if (BUTTON_NUM_IS_PRESSED)
+            else
             {
-                // Change interrupt edge to detect button release
-                BUTTONS_IES |= BUTTON_NUM_PIN;
-                button.flag.num = 0;
-                // This flag is used to detect if the user released the button before the
-                // time for a long button press (3s)
-                button.flag.num_not_long = 1;
+                sButton.num_gap = CONV_MS_TO_SAMPLES(BUTTONS_DOUBLE_TIME);
             }
         }
+        sButton.num_hold = 0;
+    }
+    if (((released & (BUTTON_UP_PIN | BUTTON_DOWN_PIN)) != 0) &&
+        ((pins & (BUTTON_UP_PIN | BUTTON_DOWN_PIN)) == 0))
+    {
+        // Reset repeat counter
+        sButton.repeats = 0;
+        sButton.repeat_next = 0;
 
+        // Enable blinking
+        if (sys.flag.up_down_repeat_enabled)
+            start_blink();
     }
-    // Reenable PORT2 IRQ
-    __disable_interrupt();
-    BUTTONS_IFG = 0x00;
-    BUTTONS_IE = int_enable;
-    __enable_interrupt();
 
-    // Exit from LPM3/LPM4 on RETI
-    __bic_SR_register_on_exit(LPM4_bits);
+    // Continue sampling while a button is pressed or a double press may follow
+    if (pins || raw || sButton.star_gap || sButton.num_gap)
+    {
+        Timer0_A0_Start(CONV_MS_TO_TICKS(BUTTONS_SAMPLE_TIME));
+    }
+    else
+    {
+        // Ignore bouncing noise and enable button IRQs again
+        BUTTONS_IFG &= ~ALL_BUTTONS;
+        BUTTONS_IE |= sButton.sample_ie;
+    }
+
+    return ((button.all_flags & ~flags) != 0);
 }
 
 // *************************************************************************************************
-// @fn          button_repeat_on
-// @brief       Start button auto repeat timer.
+// @fn          tick_backlight
+// @brief       One-shot timer job. Turns backlight off after timeout.
 // @param       none
 // @return      none
 // *************************************************************************************************
-void button_repeat_on(u16 msec)
+void tick_backlight(void)
 {
-    // Set button repeat flag
-    sys.flag.up_down_repeat_enabled = 1;
-
-    // Set Timer0_A3 function pointer to button repeat function
-    fptr_Timer0_A3_function = button_repeat_function;
-
-    // Timer0_A3 IRQ triggers every 200ms
-    Timer0_A3_Start(CONV_MS_TO_TICKS(msec));
+    P2OUT &= ~BUTTON_BACKLIGHT_PIN;
+    P2DIR &= ~BUTTON_BACKLIGHT_PIN;
+    sButton.backlight_status = 0;
+    power_off(POWER_BACKLIGHT);
 }
 
 // *************************************************************************************************
-// @fn          button_repeat_off
-// @brief       Stop button auto repeat timer.
+// @fn          button_lock_toggle
+// @brief       Lock / unlock buttons after NUM + DOWN were held together.
 // @param       none
 // @return      none
 // *************************************************************************************************
-void button_repeat_off(void)
+void button_lock_toggle(void)
 {
-    // Clear button repeat flag
-    sys.flag.up_down_repeat_enabled = 0;
+    // Toggle lock / unlock buttons flag
+    sys.flag.lock_buttons = ~sys.flag.lock_buttons;
 
-    // Timer0_A3 IRQ repeats with 4Hz
-    Timer0_A3_Stop();
+    // Show "buttons are locked/unlocked" message synchronously with next second tick
+    message.flag.prepare = 1;
+    if (sys.flag.lock_buttons)
+        message.flag.type_locked = 1;
+    else
+        message.flag.type_unlocked = 1;
+    timer_job_start(TIMER_JOB_MESSAGE, tick_message, 1, TIMER_JOB_PERIODIC);
 }
 
 // *************************************************************************************************
-// @fn          button_repeat_function
-// @brief       Check at regular intervals if button is pushed continuously
-//                              and trigger virtual button event.
-// @param       none
+// @fn          button_repeat_on
+// @brief       Start button auto repeat.
+// @param       u16 msec                Initial auto repeat period
 // @return      none
 // *************************************************************************************************
-void button_repeat_function(void)
+void button_repeat_on(u16 msec)
 {
-    static u8 start_delay = 10; // Wait for 2 seconds before starting auto up/down
-    u8 repeat = 0;
+    // Set auto repeat period
+    sButton.repeat_time = CONV_MS_TO_SAMPLES(msec);
 
-    // If buttons UP or DOWN are continuously high, repeatedly set button flag
-    if (BUTTON_UP_IS_PRESSED)
-    {
-        if (start_delay == 0)
-        {
-            // Generate a virtual button event
-            button.flag.up = 1;
-            repeat = 1;
-        }
-        else
-        {
-            start_delay--;
-        }
-    }
-    else if (BUTTON_DOWN_IS_PRESSED)
-    {
-        if (start_delay == 0)
-        {
-            // Generate a virtual button event
-            button.flag.down = 1;
-            repeat = 1;
-        }
-        else
-        {
-            start_delay--;
-        }
-    }
-    else
-    {
-        // Reset repeat counter
-        sButton.repeats = 0;
-        start_delay = 10;
-
-        // Enable blinking
-        start_blink();
-    }
-
-    // If virtual button event is generated, stop blinking and reset timeout counter
-    if (repeat)
-    {
-        // Increase repeat counter
-        sButton.repeats++;
-
-        // Reset inactivity detection counter
-        sTime.last_activity = sTime.system_time;
-
-        // Disable blinking
-        stop_blink();
-    }
+    // Set button repeat flag
+    sys.flag.up_down_repeat_enabled = 1;
 }
 
+// *************************************************************************************************
+// @fn          button_repeat_off
+// @brief       Stop button auto repeat.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void button_repeat_off(void)
+{
+    // Clear button repeat flag
+    sys.flag.up_down_repeat_enabled = 0;
+}
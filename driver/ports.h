@@ -75,12 +75,18 @@
 #define BUTTON_BACKLIGHT_IS_RELEASED    ((BUTTONS_IN & BUTTON_BACKLIGHT_PIN) == 0)
 
 // Button debounce time (msec)
-#define BUTTONS_DEBOUNCE_TIME_IN        (5u)
 #define BUTTONS_DEBOUNCE_TIME_OUT       (250u)
-#define BUTTONS_DEBOUNCE_TIME_LEFT      (50u)
 
-// Detect if STAR / NUM button is held low continuously
-#define LEFT_BUTTON_LONG_TIME           (2u)
+// Button sample period (msec) - button state is valid after two equal samples
+#define BUTTONS_SAMPLE_TIME             (10u)
+#define CONV_MS_TO_SAMPLES(msec)        ((msec) / BUTTONS_SAMPLE_TIME)
+
+// Button gesture times (msec)
+#define BUTTONS_LONG_TIME               (2000u) // Hold STAR / NUM for long button press
+#define BUTTONS_DOUBLE_TIME             (300u)  // Max. pause between two presses of double press
+#define BUTTONS_CHORD_TIME              (2000u) // Hold NUM + DOWN to lock / unlock buttons
+#define BUTTONS_REPEAT_DELAY            (1000u) // Hold UP / DOWN before auto repeat starts
+#define BUTTONS_REPEAT_TIME_MIN         (50u)   // Fastest auto repeat period
 
 // Backlight time  (sec)
 #define BACKLIGHT_TIME_ON                       (3u)
@@ -101,8 +107,8 @@ typedef union
         u16 backlight : 1;      // Short BACKLIGHT button press
         u16 star_long : 1;      // Long STAR button press
         u16 num_long : 1;       // Long NUM button press
-        u16 star_not_long : 1;  // Between short and long STAR button press
-        u16 num_not_long : 1;   // Between short and long NUM button press
+        u16 star_double : 1;    // Second short STAR button press within BUTTONS_DOUBLE_TIME
+        u16 num_double : 1;     // Second short NUM button press within BUTTONS_DOUBLE_TIME
     } flag;
     u16 all_flags;              // Shortcut to all display flags (for reset)
 } s_button_flags;
@@ -110,13 +116,19 @@ extern volatile s_button_flags button;
 
 struct struct_button
 {
-    u8 star_timeout;            // this variable is incremented each second if STAR button is still
-                                // pressed
-    u8 num_timeout;             // this variable is incremented each second if NUM button is still
-                                // pressed
-    u8 backlight_timeout;       // controls the timeout for the backlight
     u8 backlight_status;        // 1 case backlight is on
-    s16 repeats;
+    s16 repeats;                // Number of auto repeat events while UP / DOWN is held
+    u8 sample;                  // Last button sample
+    u8 pins;                    // Debounced button state
+    u8 sample_ie;               // Button IRQ enable bits to restore when sampling stops
+    u16 star_hold;              // Samples since STAR press, 0 = press already consumed
+    u16 num_hold;               // Samples since NUM press, 0 = press already consumed
+    u16 chord_hold;             // Samples since NUM + DOWN press, 0 = no chord
+    u16 star_gap;               // Samples left to detect STAR double press
+    u16 num_gap;                // Samples left to detect NUM double press
+    u16 repeat_time;            // Auto repeat period set by button_repeat_on (samples)
+    u16 repeat_period;          // Current auto repeat period (samples)
+    u16 repeat_next;            // Samples until next auto repeat event
 };
 extern volatile struct struct_button sButton;
 
@@ -124,7 +136,8 @@ extern volatile struct struct_button sButton;
 // Extern section
 extern void button_repeat_on(u16 msec);
 extern void button_repeat_off(void);
-extern void button_repeat_function(void);
 extern void init_buttons(void);
+extern void tick_backlight(void);
+extern u8 button_sample(void);
 
 #endif                          /*PORTS_H_ */
@@ -0,0 +1,310 @@
+// *************************************************************************************************
+// Power consumption accounting. Active time and on-time of peripherals are weighted with their
+// typical current consumption to estimate consumed charge and remaining battery life.
+// *************************************************************************************************
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// driver
+#include "power.h"
+#include "rtc.h"
+
+// *************************************************************************************************
+// Prototypes section
+void reset_power(void);
+void power_on(u8 device);
+void power_off(u8 device);
+void power_update(void);
+void power_rebase(void);
+void power_sleep(void);
+void power_wakeup(void);
+u16 power_get_average_current(void);
+u16 power_get_remaining_days(void);
+void power_charge(u16 current, u32 time);
+u16 power_timer(void);
+
+// *************************************************************************************************
+// Defines section
+
+// Longest period accounted at once (1/128 sec) - keeps charge calculation within 32 bit
+#define POWER_PERIOD_MAX                (60 * (u32) RTC_TIMESTAMP_PER_SEC)
+
+// 1 uAh in uA * 1/128 sec
+#define POWER_CHARGE_UAH                (60 * 60 * (u32) RTC_TIMESTAMP_PER_SEC)
+
+// *************************************************************************************************
+// Global Variable section
+struct power sPower;
+
+// Current consumption of each device (uA)
+const u16 power_current[POWER_DEVICES] = {
+    POWER_CURRENT_RADIO,
+    POWER_CURRENT_ACCELERATION,
+    POWER_CURRENT_PRESSURE,
+    POWER_CURRENT_BUZZER,
+    POWER_CURRENT_BACKLIGHT,
+};
+
+// *************************************************************************************************
+// Extern section
+
+// *************************************************************************************************
+// @fn          reset_power
+// @brief       Restart power accounting. All devices are off.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void reset_power(void)
+{
+    u16 int_state;
+    u8 i;
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    sPower.on = 0;
+    sPower.last = rtc_get_timestamp();
+    sPower.wakeup = power_timer();
+    sPower.active_ticks = 0;
+    sPower.time = 0;
+    sPower.active = 0;
+    for (i = 0; i < POWER_DEVICES; i++)
+        sPower.on_time[i] = 0;
+    sPower.charge = 0;
+    sPower.charge_rest = 0;
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          power_on
+// @brief       Start on-time accounting of a device.
+// @param       u8 device               POWER_xxx
+// @return      none
+// *************************************************************************************************
+void power_on(u8 device)
+{
+    u16 int_state;
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    if ((sPower.on & (1 << device)) == 0)
+    {
+        power_update();
+        sPower.on |= 1 << device;
+    }
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          power_off
+// @brief       Stop on-time accounting of a device.
+// @param       u8 device               POWER_xxx
+// @return      none
+// *************************************************************************************************
+void power_off(u8 device)
+{
+    u16 int_state;
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    if ((sPower.on & (1 << device)) != 0)
+    {
+        power_update();
+        sPower.on &= ~(1 << device);
+    }
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          power_update
+// @brief       Account time since last update. Called on every device change and by the
+//                              RTC_A minute event, so that no period is longer than one day.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void power_update(void)
+{
+    u16 int_state;
+    u32 now, time, active;
+    u8 i;
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    // Elapsed time, time of day rolls over at midnight
+    now = rtc_get_timestamp();
+    time = (now + RTC_TIMESTAMP_PER_DAY - sPower.last) % RTC_TIMESTAMP_PER_DAY;
+    sPower.last = now;
+
+    // Active time (1/32768 sec to 1/128 sec)
+    active = sPower.active_ticks >> 8;
+    sPower.active_ticks &= 0xFF;
+
+    // Base current in LPM3 and additional current while CPU is active
+    sPower.time += time;
+    sPower.active += active;
+    power_charge(POWER_CURRENT_LPM3, time);
+    power_charge(POWER_CURRENT_ACTIVE - POWER_CURRENT_LPM3, active);
+
+    // Peripherals
+    for (i = 0; i < POWER_DEVICES; i++)
+    {
+        if ((sPower.on & (1 << i)) != 0)
+        {
+            sPower.on_time[i] += time;
+            power_charge(power_current[i], time);
+        }
+    }
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          power_rebase
+// @brief       Continue accounting from current time of day. Called after time was set.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void power_rebase(void)
+{
+    u16 int_state;
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    sPower.last = rtc_get_timestamp();
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          power_charge
+// @brief       Add charge to consumed charge.
+// @param       u16 current             Current (uA)
+//                              u32 time                Time (1/128 sec)
+// @return      none
+// *************************************************************************************************
+void power_charge(u16 current, u32 time)
+{
+    u32 period;
+
+    while (time > 0)
+    {
+        period = (time > POWER_PERIOD_MAX) ? POWER_PERIOD_MAX : time;
+        time -= period;
+
+        sPower.charge_rest += current * period;
+        sPower.charge += sPower.charge_rest / POWER_CHARGE_UAH;
+        sPower.charge_rest %= POWER_CHARGE_UAH;
+    }
+}
+
+// *************************************************************************************************
+// @fn          power_timer
+// @brief       Read Timer0 counter.
+// @param       none
+// @return      u16             Timer0 counter (1/32768 sec)
+// *************************************************************************************************
+u16 power_timer(void)
+{
+    u16 value = 0;
+
+    // Timer0 runs from ACLK - to make sure this value is correctly read
+    while (value != TA0R)
+        value = TA0R;
+
+    return (value);
+}
+
+// *************************************************************************************************
+// @fn          power_sleep
+// @brief       Add time since wakeup to active time. Called before going to LPM3. Active
+//                              periods are expected to be shorter than one Timer0 period (2 sec).
+//                              Only main loop activity is counted, see
+//                              power_get_average_current().
+// @param       none
+// @return      none
+// *************************************************************************************************
+void power_sleep(void)
+{
+    u16 int_state;
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    sPower.active_ticks += (u16) (power_timer() - sPower.wakeup);
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          power_wakeup
+// @brief       Start active time accounting. Called after wakeup from LPM3.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void power_wakeup(void)
+{
+    sPower.wakeup = power_timer();
+}
+
+// *************************************************************************************************
+// @fn          power_get_average_current
+// @brief       Average current consumption since reset. Estimate is low: CPU time of ISRs that
+//                              return to LPM3 without waking the main loop (button sampling with
+//                              Timer0_A0, RTC clock tick, radio) is not counted as active time.
+//                              At the usual rate of a few such wakeups per second this is well
+//                              below the 1 uA resolution while no button is held.
+// @param       none
+// @return      u16             Current (uA), 0 = not known yet
+// *************************************************************************************************
+u16 power_get_average_current(void)
+{
+    u32 seconds = sPower.time / RTC_TIMESTAMP_PER_SEC;
+    u32 current;
+
+    if (seconds == 0)
+        return (0);
+
+    // uAh * 3600 = uAs, plus rest in uA * 1/128 sec
+    current = (sPower.charge * 3600 + sPower.charge_rest / RTC_TIMESTAMP_PER_SEC) / seconds;
+
+    if (current > 0xFFFF)
+        current = 0xFFFF;
+
+    return ((u16) current);
+}
+
+// *************************************************************************************************
+// @fn          power_get_remaining_days
+// @brief       Estimate remaining battery life from average current consumption.
+// @param       none
+// @return      u16             Remaining days, 0xFFFF = not known yet
+// *************************************************************************************************
+u16 power_get_remaining_days(void)
+{
+    u16 current = power_get_average_current();
+    u32 days;
+
+    if (current == 0)
+        return (0xFFFF);
+
+    if (sPower.charge >= POWER_BATTERY_CAPACITY)
+        return (0);
+
+    days = (POWER_BATTERY_CAPACITY - sPower.charge) / current / 24;
+
+    if (days > 0xFFFE)
+        days = 0xFFFE;
+
+    return ((u16) days);
+}
@@ -0,0 +1,75 @@
+// *************************************************************************************************
+// Power consumption accounting interface and typical currents of each part.
+// *************************************************************************************************
+
+#ifndef POWER_H_
+#define POWER_H_
+
+// *************************************************************************************************
+// Include section
+
+// *************************************************************************************************
+// Prototypes section
+extern void reset_power(void);
+extern void power_on(u8 device);
+extern void power_off(u8 device);
+extern void power_update(void);
+extern void power_rebase(void);
+extern void power_sleep(void);
+extern void power_wakeup(void);
+extern u16 power_get_average_current(void);
+extern u16 power_get_remaining_days(void);
+
+// *************************************************************************************************
+// Defines section
+
+// Devices with accounted on-time
+#define POWER_RADIO                     (0u)
+#define POWER_ACCELERATION              (1u)
+#define POWER_PRESSURE                  (2u)
+#define POWER_BUZZER                    (3u)
+#define POWER_BACKLIGHT                 (4u)
+#define POWER_DEVICES                   (5u)
+
+// Typical current consumption (uA)
+#define POWER_CURRENT_LPM3              (5u)     // CC430 in LPM3 with RTC and LCD
+#define POWER_CURRENT_ACTIVE            (3000u)  // CC430 CPU at 12 MHz
+#define POWER_CURRENT_RADIO             (16000u) // RX / TX at 0 dBm
+#define POWER_CURRENT_ACCELERATION      (70u)    // Sensor at 100 Hz output data rate
+#define POWER_CURRENT_PRESSURE          (25u)    // Sensor in continuous measurement mode
+#define POWER_CURRENT_BUZZER            (3000u)
+#define POWER_CURRENT_BACKLIGHT         (4000u)
+
+// CR2032 capacity (uAh)
+#define POWER_BATTERY_CAPACITY          (220000u)
+
+struct power
+{
+    // Bit n set = device n is on
+    u8 on;
+
+    // Time of day of last accounting (1/128 sec)
+    u32 last;
+
+    // Timer0 counter when CPU woke up, active time not accounted yet (1/32768 sec)
+    u16 wakeup;
+    u32 active_ticks;
+
+    // Time since reset, active time and on-time of each device (1/128 sec)
+    u32 time;
+    u32 active;
+    u32 on_time[POWER_DEVICES];
+
+    // Consumed charge (uAh) and rest not accounted in charge yet (uA * 1/128 sec)
+    u32 charge;
+    u32 charge_rest;
+};
+
+// *************************************************************************************************
+// Global Variable section
+extern struct power sPower;
+
+// *************************************************************************************************
+// Extern section
+
+#endif                          /*POWER_H_ */
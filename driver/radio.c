@@ -41,6 +41,8 @@
 // driver
 #include "rf1a.h"
 #include "timer.h"
+#include "power.h"
+#include "task.h"
 
 // logic
 #include "rfsimpliciti.h"
@@ -127,6 +129,8 @@ void open_radio(void)
     // Enable radio IRQ
     RF1AIFG &= ~BIT4;           // Clear a pending interrupt
     RF1AIE |= BIT4;             // Enable the interrupt
+
+    power_on(POWER_RADIO);
 }
 
 // *************************************************************************************************
@@ -146,6 +150,8 @@ void close_radio(void)
 
     // Put radio to sleep
     radio_powerdown();
+
+    power_off(POWER_RADIO);
 }
 
 // *************************************************************************************************
@@ -166,6 +172,10 @@ __interrupt void radio_ISR(void)
     if (is_rf())
     {
         MRFI_RadioIsr();
+
+        // Received frame has ended a delay or a protothread wait - exit from LPM3 on RETI
+        if (sys.flag.delay_over || sTask.wakeup)
+            _BIC_SR_IRQ(LPM3_bits);
     }
     else                                  // BlueRobin packet end interrupt service routine
     {
@@ -0,0 +1,378 @@
+// *************************************************************************************************
+// RTC_A calendar driver. Generates clock tick, minute tick and alarm.
+// *************************************************************************************************
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// driver
+#include "rtc.h"
+#include "timer.h"
+#include "event.h"
+#include "power.h"
+#include "display.h"
+
+// logic
+#include "clock.h"
+#include "alarm.h"
+#include "rfsimpliciti.h"
+#include "simpliciti.h"
+#include "profile.h"
+#include "logger.h"
+
+// *************************************************************************************************
+// Prototypes section
+void rtc_init(void);
+void rtc_start(void);
+void rtc_stop(void);
+void rtc_tick_second(void);
+void rtc_tick_minute(void);
+void rtc_set_time(u8 hour, u8 minute, u8 second);
+void rtc_get_time(u8 * hour, u8 * minute, u8 * second);
+void rtc_set_date(u16 year, u8 month, u8 day);
+void rtc_get_date(u16 * year, u8 * month, u8 * day);
+void rtc_set_alarm(u8 hour, u8 minute);
+u32 rtc_get_timestamp(void);
+void rtc_wait_ready(void);
+
+// *************************************************************************************************
+// Defines section
+
+// *************************************************************************************************
+// Global Variable section
+
+// *************************************************************************************************
+// Extern section
+
+// *************************************************************************************************
+// @fn          rtc_init
+// @brief       Set RTC_A to calendar mode and start it. Time, date and alarm are set later by
+//                              reset_clock(), reset_date() and reset_alarm().
+// @param       none
+// @return      none
+// *************************************************************************************************
+void rtc_init(void)
+{
+    // Hold RTC, calendar mode, binary format, event IRQ when minute changes
+    RTCCTL01 = RTCHOLD + RTCMODE + RTCTEV_0;
+
+    // Alarm is off until it is set
+    RTCAMIN = 0;
+    RTCAHOUR = 0;
+    RTCADOW = 0;
+    RTCADAY = 0;
+
+    rtc_start();
+}
+
+// *************************************************************************************************
+// @fn          rtc_start
+// @brief       Start RTC with 1 sec clock tick and minute tick.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void rtc_start(void)
+{
+    // Reset IRQ flags
+    RTCCTL01 &= ~(RTCTEVIFG + RTCAIFG + RTCRDYIFG);
+
+    // Enable ready IRQ (1/1sec) and event IRQ (1/1min)
+    RTCCTL01 |= RTCTEVIE + RTCRDYIE;
+
+    // Start counting
+    RTCCTL01 &= ~RTCHOLD;
+}
+
+// *************************************************************************************************
+// @fn          rtc_stop
+// @brief       Hold RTC and disable clock and minute tick. Alarm cannot trigger while RTC is held.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void rtc_stop(void)
+{
+    RTCCTL01 |= RTCHOLD;
+    RTCCTL01 &= ~(RTCTEVIE + RTCRDYIE);
+}
+
+// *************************************************************************************************
+// @fn          rtc_tick_second
+// @brief       Assert clock tick IRQ every second. Missed seconds are caught up by next
+//                              clock_tick(), as time is read from calendar registers.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void rtc_tick_second(void)
+{
+    if (RTCCTL01 & RTCRDYIE)
+        return;
+
+    // Next clock tick at next full second
+    RTCCTL01 &= ~RTCRDYIFG;
+    RTCCTL01 |= RTCRDYIE;
+}
+
+// *************************************************************************************************
+// @fn          rtc_tick_minute
+// @brief       Only wake up with minute event IRQ.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void rtc_tick_minute(void)
+{
+    RTCCTL01 &= ~RTCRDYIE;
+}
+
+// *************************************************************************************************
+// @fn          rtc_wait_ready
+// @brief       Wait until calendar registers are safe for reading. They are not while RTC updates
+//                              them once per second.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void rtc_wait_ready(void)
+{
+    while ((RTCCTL01 & (RTCRDY + RTCHOLD)) == 0) ;
+}
+
+// *************************************************************************************************
+// @fn          rtc_set_time
+// @brief       Set calendar time. Next second starts now.
+// @param       u8 hour                 0..23
+//                              u8 minute               0..59
+//                              u8 second               0..59
+// @return      none
+// *************************************************************************************************
+void rtc_set_time(u8 hour, u8 minute, u8 second)
+{
+    u16 hold = RTCCTL01 & RTCHOLD;
+
+    // Account power consumption up to now with old time
+    power_update();
+
+    RTCCTL01 |= RTCHOLD;
+
+    RTCHOUR = hour;
+    RTCMIN = minute;
+    RTCSEC = second;
+
+    // Restart current second
+    RTCPS = 0;
+
+    if (!hold)
+        RTCCTL01 &= ~RTCHOLD;
+
+    // Continue power accounting from new time
+    power_rebase();
+}
+
+// *************************************************************************************************
+// @fn          rtc_get_time
+// @brief       Read calendar time.
+// @param       u8 *hour                0..23
+//                              u8 *minute              0..59
+//                              u8 *second              0..59
+// @return      none
+// *************************************************************************************************
+void rtc_get_time(u8 * hour, u8 * minute, u8 * second)
+{
+    rtc_wait_ready();
+
+    *hour = RTCHOUR;
+    *minute = RTCMIN;
+    *second = RTCSEC;
+}
+
+// *************************************************************************************************
+// @fn          rtc_get_timestamp
+// @brief       Read time of day with 1/128 sec resolution. Can be called from any context, as it
+//                              does not wait for RTC ready.
+// @param       none
+// @return      u32             Time since midnight in 1/128 sec (0 .. RTC_TIMESTAMP_PER_DAY-1)
+// *************************************************************************************************
+u32 rtc_get_timestamp(void)
+{
+    u8 hour, minute, second, fraction;
+
+    // Read until registers did not change while reading. RT1PS counts with 128 Hz in calendar
+    // mode, its lower 7 bits are the fraction of the current second.
+    do
+    {
+        fraction = (RTCPS >> 8) & 0x7F;
+        second = RTCSEC;
+        minute = RTCMIN;
+        hour = RTCHOUR;
+    }
+    while (fraction != ((RTCPS >> 8) & 0x7F) || second != RTCSEC);
+
+    return ((((u32) hour * 60 + minute) * 60 + second) * RTC_TIMESTAMP_PER_SEC + fraction);
+}
+
+// *************************************************************************************************
+// @fn          rtc_set_date
+// @brief       Set calendar date. RTC_A treats every year divisible by 4 as leap year.
+// @param       u16 year                1901..2099
+//                              u8 month                1..12
+//                              u8 day                  1..31
+// @return      none
+// *************************************************************************************************
+void rtc_set_date(u16 year, u8 month, u8 day)
+{
+    u16 hold = RTCCTL01 & RTCHOLD;
+
+    RTCCTL01 |= RTCHOLD;
+
+    RTCYEAR = year;
+    RTCMON = month;
+    RTCDAY = day;
+
+    if (!hold)
+        RTCCTL01 &= ~RTCHOLD;
+}
+
+// *************************************************************************************************
+// @fn          rtc_get_date
+// @brief       Read calendar date.
+// @param       u16 *year               Year
+//                              u8 *month               1..12
+//                              u8 *day                 1..31
+// @return      none
+// *************************************************************************************************
+void rtc_get_date(u16 * year, u8 * month, u8 * day)
+{
+    rtc_wait_ready();
+
+    *year = RTCYEAR;
+    *month = RTCMON;
+    *day = RTCDAY;
+}
+
+// *************************************************************************************************
+// @fn          rtc_set_alarm
+// @brief       Assert alarm IRQ every day at given time.
+// @param       u8 hour                 0..23
+//                              u8 minute               0..59
+// @return      none
+// *************************************************************************************************
+void rtc_set_alarm(u8 hour, u8 minute)
+{
+    // Disable alarm IRQ while alarm registers change
+    RTCCTL01 &= ~RTCAIE;
+
+    RTCAMIN = minute | RTC_ALARM_ENABLE;
+    RTCAHOUR = hour | RTC_ALARM_ENABLE;
+
+    RTCCTL01 &= ~RTCAIFG;
+    RTCCTL01 |= RTCAIE;
+}
+
+// *************************************************************************************************
+// @fn          RTC_A_ISR
+// @brief       IRQ handler for RTC_A IRQ
+//                              RTCRDYIFG       1/1sec clock tick (only enabled while needed)
+//                              RTCTEVIFG       1/1min minute tick
+//                              RTCAIFG         Alarm time reached
+// @param       none
+// @return      none
+// *************************************************************************************************
+#pragma vector = RTC_VECTOR
+__interrupt void RTC_A_ISR(void)
+{
+    PROFILE_ENTER();
+
+    switch (RTCIV)
+    {
+        // RTCRDYIFG    1/1sec clock tick
+        case 0x02:
+            // Copy calendar to global time
+            clock_tick();
+
+            // Set clock update flag
+            display.flag.update_time = 1;
+
+            // While SimpliciTI stack operates or BlueRobin searches, freeze system state
+            if (is_rf())
+            {
+                // SimpliciTI automatic timeout
+                if (sRFsmpl.timeout == 0)
+                {
+                    simpliciti_flag |= SIMPLICITI_TRIGGER_STOP;
+                }
+                else
+                {
+                    sRFsmpl.timeout--;
+                }
+
+                // switch message after received packet
+                if (sRFsmpl.mode == SIMPLICITI_SYNC)
+                {
+                    if (sRFsmpl.display_sync_done == 0)
+                    {
+                        display_bitmap(&lcd_bmp_sync, SEG_ON);
+                    }
+                    else
+                    {
+                        sRFsmpl.display_sync_done--;
+                    }
+                }
+
+                // Jobs do not count down while radio is active
+                timer_hold_jobs();
+                break;
+            }
+
+            // Service registered jobs that are due
+            timer_service_jobs();
+
+            // Only wake up once a minute while nothing needs 1 sec resolution
+            if (!is_second_tick_needed())
+                rtc_tick_minute();
+            break;
+
+        // RTCTEVIFG    1/1min minute tick
+        case 0x04:
+            // No clock tick in minute tick mode - copy calendar to global time and service
+            // jobs now
+            if ((RTCCTL01 & RTCRDYIE) == 0)
+            {
+                clock_tick();
+                display.flag.update_time = 1;
+
+                timer_service_jobs();
+
+                // A job is due within the next minute
+                if (is_second_tick_needed())
+                    rtc_tick_second();
+            }
+
+#ifdef USE_PROFILING
+            timer_check_tick_mode();
+#endif
+
+            // Measure battery voltage to keep track of remaining battery life - not while radio
+            // is active, as it would measure voltage under load
+            if (!is_rf())
+                event_post(EVENT_VOLTAGE_MEASUREMENT, 0);
+
+            // Write data log record
+            if ((sTime.minute % LOGGER_INTERVAL) == 0)
+                event_post(EVENT_LOGGER, 0);
+
+            // Account power consumption at least once a minute
+            power_update();
+            break;
+
+        // RTCAIFG      Alarm time reached
+        case 0x06:
+            check_alarm();
+            break;
+    }
+
+    PROFILE_EXIT(PROFILE_RTC_A);
+
+    // Exit from LPM3 on RETI
+    _BIC_SR_IRQ(LPM3_bits);
+}
@@ -0,0 +1,41 @@
+// *************************************************************************************************
+// RTC_A calendar driver interface.
+// *************************************************************************************************
+
+#ifndef RTC_H_
+#define RTC_H_
+
+// *************************************************************************************************
+// Include section
+
+// *************************************************************************************************
+// Prototypes section
+extern void rtc_init(void);
+extern void rtc_start(void);
+extern void rtc_stop(void);
+extern void rtc_tick_second(void);
+extern void rtc_tick_minute(void);
+extern void rtc_set_time(u8 hour, u8 minute, u8 second);
+extern void rtc_get_time(u8 * hour, u8 * minute, u8 * second);
+extern void rtc_set_date(u16 year, u8 month, u8 day);
+extern void rtc_get_date(u16 * year, u8 * month, u8 * day);
+extern void rtc_set_alarm(u8 hour, u8 minute);
+extern u32 rtc_get_timestamp(void);
+
+// *************************************************************************************************
+// Defines section
+
+// Alarm register enable bit
+#define RTC_ALARM_ENABLE                (BIT7)
+
+// Timestamp resolution (1/128 sec) and range (1 day)
+#define RTC_TIMESTAMP_PER_SEC           (128u)
+#define RTC_TIMESTAMP_PER_DAY           (24 * 60 * 60 * (u32) RTC_TIMESTAMP_PER_SEC)
+
+// *************************************************************************************************
+// Global Variable section
+
+// *************************************************************************************************
+// Extern section
+
+#endif                          /*RTC_H_ */
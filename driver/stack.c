@@ -0,0 +1,112 @@
+// *************************************************************************************************
+// Stack and RAM usage monitor. RAM between static variables and stack is painted at startup, so
+// that the deepest stack use since reset can be found later. The stack grows down from the top of
+// RAM and may grow beyond its linker size into unused RAM, this is detected as well.
+// *************************************************************************************************
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// driver
+#include "stack.h"
+
+// *************************************************************************************************
+// Prototypes section
+void stack_paint(void);
+u16 stack_get_peak(void);
+u16 stack_get_size(void);
+u16 ram_get_static(void);
+u16 ram_get_free(void);
+
+// *************************************************************************************************
+// Defines section
+
+// *************************************************************************************************
+// Global Variable section
+
+// *************************************************************************************************
+// Extern section
+
+// Section boundaries, defined in linker command file
+extern u16 ram_bss_start;
+extern u16 ram_bss_end;
+extern u16 ram_stack_start;
+extern u16 ram_stack_end;
+
+// *************************************************************************************************
+// @fn          stack_paint
+// @brief       Fill unused RAM below current stack pointer with STACK_PAINT. Called once at
+//                              startup.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void stack_paint(void)
+{
+    u16 *ptr = (u16 *) (((u16) & ram_bss_end + 1) & ~1);
+    u16 *sp;
+    u16 int_state;
+
+    // No interrupt may use the stack while it is painted
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    sp = (u16 *) __get_SP_register();
+    while (ptr < sp)
+        *ptr++ = STACK_PAINT;
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          stack_get_peak
+// @brief       Find deepest stack use since reset (stack high-water mark).
+// @param       none
+// @return      u16             Stack use (bytes), can be larger than stack_get_size()
+// *************************************************************************************************
+u16 stack_get_peak(void)
+{
+    u16 *ptr = (u16 *) (((u16) & ram_bss_end + 1) & ~1);
+
+    // First overwritten word from bottom is deepest stack use
+    while ((ptr < &ram_stack_end) && (*ptr == STACK_PAINT))
+        ptr++;
+
+    return ((u16) & ram_stack_end - (u16) ptr);
+}
+
+// *************************************************************************************************
+// @fn          stack_get_size
+// @brief       Stack size reserved by linker.
+// @param       none
+// @return      u16             Stack size (bytes)
+// *************************************************************************************************
+u16 stack_get_size(void)
+{
+    return ((u16) & ram_stack_end - (u16) & ram_stack_start);
+}
+
+// *************************************************************************************************
+// @fn          ram_get_static
+// @brief       RAM used by global and static variables.
+// @param       none
+// @return      u16             Static RAM (bytes)
+// *************************************************************************************************
+u16 ram_get_static(void)
+{
+    return ((u16) & ram_bss_end - (u16) & ram_bss_start);
+}
+
+// *************************************************************************************************
+// @fn          ram_get_free
+// @brief       RAM that was never used since reset, between static variables and deepest
+//                              stack use.
+// @param       none
+// @return      u16             Free RAM (bytes)
+// *************************************************************************************************
+u16 ram_get_free(void)
+{
+    return ((u16) & ram_stack_end - (u16) & ram_bss_end - stack_get_peak());
+}
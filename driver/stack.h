@@ -0,0 +1,31 @@
+// *************************************************************************************************
+// Stack and RAM usage monitor interface.
+// *************************************************************************************************
+
+#ifndef STACK_H_
+#define STACK_H_
+
+// *************************************************************************************************
+// Include section
+
+// *************************************************************************************************
+// Prototypes section
+extern void stack_paint(void);
+extern u16 stack_get_peak(void);
+extern u16 stack_get_size(void);
+extern u16 ram_get_static(void);
+extern u16 ram_get_free(void);
+
+// *************************************************************************************************
+// Defines section
+
+// Pattern written to unused RAM at startup
+#define STACK_PAINT                     (0xA5A5u)
+
+// *************************************************************************************************
+// Global Variable section
+
+// *************************************************************************************************
+// Extern section
+
+#endif                          /*STACK_H_ */
@@ -0,0 +1,141 @@
+// *************************************************************************************************
+// Background tasks. Tasks are protothreads that run from the main loop in idle_loop(). Foreground
+// flows (menu settings with set_value(), RF sessions) are protothreads run by TASK_FLOW.
+// Timer0_A4_Delay() only runs tasks that do not use blocking drivers.
+// *************************************************************************************************
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// driver
+#include "task.h"
+#include "display.h"
+
+// logic
+#include "stopwatch.h"
+
+// *************************************************************************************************
+// Prototypes section
+void task_init(void);
+u8 task_run(u16 tasks);
+void task_flow_start(u8 (*flow)(struct pt *pt));
+u8 is_task_flow(void);
+PT_THREAD(task_flow(struct pt *pt));
+
+// *************************************************************************************************
+// Defines section
+
+// *************************************************************************************************
+// Global Variable section
+struct task sTask;
+
+// *************************************************************************************************
+// Extern section
+extern PT_THREAD(task_requests(struct pt *pt));
+
+// Task functions, index is TASK_xxx
+u8 (*const task_function[TASKS])(struct pt *pt) = {
+    task_requests,              // TASK_REQUESTS
+    task_flow,                  // TASK_FLOW
+    task_stopwatch,             // TASK_STOPWATCH
+};
+
+// *************************************************************************************************
+// @fn          task_init
+// @brief       Start all tasks from beginning.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void task_init(void)
+{
+    u8 i;
+
+    for (i = 0; i < TASKS; i++)
+        PT_INIT(&sTask.pt[i]);
+
+    sTask.running = 0;
+    sTask.flow = NULL;
+}
+
+// *************************************************************************************************
+// @fn          task_run
+// @brief       Continue given tasks until they wait. A task is never run nested, so a task that
+//                              calls a blocking function does not run again from its wait loop.
+//                              Blocking drivers (ADC12, sensors, radio) are not reentrant, so wait
+//                              loops must only run TASK_NONBLOCKING.
+// @param       u16 tasks       Bit n set = run task n (TASK_ALL, TASK_NONBLOCKING)
+// @return      u8              1 = a task yielded and can continue immediately, 0 = all tasks wait
+// *************************************************************************************************
+u8 task_run(u16 tasks)
+{
+    u8 i;
+    u16 mask;
+    u8 yielded = 0;
+
+    for (i = 0, mask = 1; i < TASKS; i++, mask <<= 1)
+    {
+        if ((tasks & mask) == 0 || (sTask.running & mask))
+            continue;
+
+        sTask.running |= mask;
+        if (task_function[i](&sTask.pt[i]) == PT_YIELDED)
+            yielded = 1;
+        sTask.running &= ~mask;
+    }
+
+    return (yielded);
+}
+
+// *************************************************************************************************
+// @fn          task_flow_start
+// @brief       Start a foreground flow. While it runs, the main loop leaves buttons and display to
+//                              the flow. Ignored while another flow runs.
+// @param       u8 (*flow)(struct pt *pt)       Flow protothread
+// @return      none
+// *************************************************************************************************
+void task_flow_start(u8 (*flow)(struct pt *pt))
+{
+    if (sTask.flow != NULL)
+        return;
+
+    PT_INIT(&sTask.flow_pt);
+    sTask.flow = flow;
+}
+
+// *************************************************************************************************
+// @fn          is_task_flow
+// @brief       Check if a foreground flow runs.
+// @param       none
+// @return      u8              1 = flow runs, 0 = no flow
+// *************************************************************************************************
+u8 is_task_flow(void)
+{
+    return (sTask.flow != NULL);
+}
+
+// *************************************************************************************************
+// @fn          task_flow
+// @brief       Background task. Runs the foreground flow started by task_flow_start() until it has
+//                              ended, then redraws the screen.
+// @param       struct pt *pt   Protothread state
+// @return      u8              PT_WAITING, PT_YIELDED
+// *************************************************************************************************
+PT_THREAD(task_flow(struct pt *pt))
+{
+    PT_BEGIN(pt);
+
+    while (1)
+    {
+        PT_WAIT_UNTIL(pt, sTask.flow != NULL);
+        PT_WAIT_THREAD(pt, sTask.flow(&sTask.flow_pt));
+        sTask.flow = NULL;
+
+        // Force full display update
+        display.flag.full_update = 1;
+    }
+
+    PT_END(pt);
+}
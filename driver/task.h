@@ -0,0 +1,57 @@
+// *************************************************************************************************
+// Background tasks interface.
+// *************************************************************************************************
+
+#ifndef TASK_H_
+#define TASK_H_
+
+// *************************************************************************************************
+// Include section
+#include "pt.h"
+
+// *************************************************************************************************
+// Prototypes section
+extern void task_init(void);
+extern u8 task_run(u16 tasks);
+extern void task_flow_start(u8 (*flow)(struct pt *pt));
+extern u8 is_task_flow(void);
+
+// *************************************************************************************************
+// Defines section
+
+// Background tasks, run by task_run() in this order
+#define TASK_REQUESTS                   (0u)
+#define TASK_FLOW                       (1u)
+#define TASK_STOPWATCH                  (2u)
+#define TASKS                           (3u)
+
+// Task sets for task_run()
+#define TASK_ALL                        ((1u << TASKS) - 1)
+
+// Tasks that do not call drivers which wait in Timer0_A4_Delay - may also run from its wait loop
+#define TASK_NONBLOCKING                (1u << TASK_STOPWATCH)
+
+struct task
+{
+    // Protothread state of each task
+    struct pt pt[TASKS];
+
+    // Bit n set = task n is running - do not run it nested
+    u16 running;
+
+    // Foreground flow (menu setting, RF session) run by TASK_FLOW, NULL = none
+    u8 (*flow)(struct pt *pt);
+    struct pt flow_pt;
+
+    // 1 = an ISR has ended a task wait since tasks last ran - do not go to LPM
+    volatile u8 wakeup;
+};
+
+// *************************************************************************************************
+// Global Variable section
+extern struct task sTask;
+
+// *************************************************************************************************
+// Extern section
+
+#endif                          /*TASK_H_ */
@@ -52,6 +52,8 @@
 #include "cma_ps.h"
 #include "ps.h"
 #include "display.h"
+#include "rtc.h"
+#include "task.h"
 
 // logic
 #include "clock.h"
@@ -65,16 +67,31 @@
 #include "acceleration.h"
 #include "temperature.h"
 #include "counter.h"
+#include "menu.h"
+#include "profile.h"
 
 // *************************************************************************************************
 // Prototypes section
 void Timer0_Init(void);
 void Timer0_Stop(void);
-void Timer0_A1_Start(void);
+void Timer0_A0_Start(u16 ticks);
+void Timer0_A1_Start(u16 ticks);
 void Timer0_A1_Stop(void);
+u8 Timer0_A1_Over(void);
 void Timer0_A3_Start(u16 ticks);
 void Timer0_A3_Stop(void);
 void Timer0_A4_Delay(u16 ticks);
+void Timer0_A4_Stop(void);
+void timer_job_start(u8 job, void (*fptr)(void), u16 period, u8 type);
+void timer_job_stop(u8 job);
+u32 timer_now(void);
+u16 timer_elapsed(u32 now);
+void timer_service_jobs(void);
+void timer_hold_jobs(void);
+u8 is_second_tick_needed(void);
+#ifdef USE_PROFILING
+void timer_check_tick_mode(void);
+#endif
 
 void (*fptr_Timer0_A3_function)(void);
 
@@ -87,26 +104,18 @@ struct timer sTimer;
 
 // *************************************************************************************************
 // Extern section
-extern void BRRX_TimerTask_v(void);
 extern void to_lpm(void);
 
 // *************************************************************************************************
 // @fn          Timer0_Init
-// @brief       Set Timer0 to a period of 1 or 2 sec. IRQ TACCR0 is asserted when timer overflows.
+// @brief       Start Timer0 in continuous mode. Clock tick is generated by RTC_A.
 // @param       none
 // @return      none
 // *************************************************************************************************
 void Timer0_Init(void)
 {
-    // Set interrupt frequency to 1Hz
-    TA0CCR0 = 32768 - 1;
-
-    // Enable timer interrupt
-    TA0CCTL0 |= CCIE;
-
     // Clear and start timer now
-    // Continuous mode: Count to 0xFFFF and restart from 0 again - 1sec timing will be generated by
-    // ISR
+    // Continuous mode: Count to 0xFFFF and restart from 0 again
     TA0CTL |= TASSEL0 + MC1 + TACLR;
 }
 
@@ -137,6 +146,89 @@ void Timer0_Stop(void)
     TA0R = 0;
 }
 
+// *************************************************************************************************
+// @fn          Timer0_A0_Start
+// @brief       Trigger one IRQ after "ticks". Used by button sampling.
+// @param       ticks (1 tick = 1/32768 sec)
+// @return      none
+// *************************************************************************************************
+void Timer0_A0_Start(u16 ticks)
+{
+    u16 value = 0;
+
+    // Delay based on current counter value
+    // To make sure this value is correctly read
+    while (value != TA0R)
+        value = TA0R;
+    value += ticks;
+
+    // Update CCR
+    TA0CCR0 = value;
+
+    // Reset IRQ flag
+    TA0CCTL0 &= ~CCIFG;
+
+    // Enable timer interrupt
+    TA0CCTL0 |= CCIE;
+}
+
+// *************************************************************************************************
+// @fn          Timer0_A1_Start
+// @brief       Start protothread delay (PT_DELAY). Timer0_A1_Over() is true after "ticks".
+// @param       ticks (1 tick = 1/32768 sec)
+// @return      none
+// *************************************************************************************************
+void Timer0_A1_Start(u16 ticks)
+{
+    u16 value = 0;
+
+    // Timer0 not running - delay is over right away
+    if ((TA0CTL & (BIT4 | BIT5)) == 0)
+    {
+        TA0CCTL1 &= ~CCIE;
+        return;
+    }
+
+    // Delay based on current counter value
+    // To make sure this value is correctly read
+    while (value != TA0R)
+        value = TA0R;
+    value += ticks;
+
+    // Update CCR
+    TA0CCR1 = value;
+
+    // Reset IRQ flag
+    TA0CCTL1 &= ~CCIFG;
+
+    // Enable timer interrupt
+    TA0CCTL1 |= CCIE;
+}
+
+// *************************************************************************************************
+// @fn          Timer0_A1_Stop
+// @brief       End protothread delay early and let a waiting protothread run. Can be called in
+//                              ISR context, the ISR must exit LPM3 when sTask.wakeup is set.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void Timer0_A1_Stop(void)
+{
+    TA0CCTL1 &= ~CCIE;
+    sTask.wakeup = 1;
+}
+
+// *************************************************************************************************
+// @fn          Timer0_A1_Over
+// @brief       Check if protothread delay is over.
+// @param       none
+// @return      u8              1 = delay over or stopped, 0 = delay running
+// *************************************************************************************************
+u8 Timer0_A1_Over(void)
+{
+    return ((TA0CCTL1 & CCIE) == 0);
+}
+
 // *************************************************************************************************
 // @fn          Timer0_A3_Start
 // @brief       Trigger IRQ every "ticks" microseconds
@@ -223,9 +315,9 @@ void Timer0_A4_Delay(u16 ticks)
         // Service watchdog
         WDTCTL = WDTPW + WDTIS__512K + WDTSSEL__ACLK + WDTCNTCL;
 #endif
-        // Redraw stopwatch display
-        if (is_stopwatch())
-            display_stopwatch(LINE2, DISPLAY_LINE_UPDATE_PARTIAL);
+        // Serve background tasks that do not use blocking drivers - the caller may be in the
+        // middle of a conversion
+        task_run(TASK_NONBLOCKING);
 
         // Check stop condition
         // disable interrupt to prevent flag's change caused by interrupt methods
@@ -237,301 +329,280 @@ void Timer0_A4_Delay(u16 ticks)
 }
 
 // *************************************************************************************************
-// @fn          TIMER0_A0_ISR
-// @brief       IRQ handler for TIMER0_A0 IRQ
-//                              Timer0_A0       1/1sec clock tick                       (serviced by
-// function TIMER0_A0_ISR)
-//                              Timer0_A1
-//                                                               (serviced by function
-// TIMER0_A1_5_ISR)
-//                              Timer0_A2       1/100 sec Stopwatch                     (serviced by
-// function TIMER0_A1_5_ISR)
-//                              Timer0_A3       Configurable periodic IRQ       (serviced by
-// function TIMER0_A1_5_ISR)
-//                              Timer0_A4       One-time delay                          (serviced by
-// function TIMER0_A1_5_ISR)
+// @fn          Timer0_A4_Stop
+// @brief       End a running Timer0_A4_Delay early. Called in ISR context, the ISR must exit
+//                              LPM3 when sys.flag.delay_over is set. Ends whatever delay waits,
+//                              so callers must know which delay they stop.
 // @param       none
 // @return      none
 // *************************************************************************************************
-#pragma vector = TIMER0_A0_VECTOR
-__interrupt void TIMER0_A0_ISR(void)
+void Timer0_A4_Stop(void)
 {
-    static u8 button_lock_counter = 0;
+    if (TA0CCTL4 & CCIE)
+    {
+        TA0CCTL4 &= ~CCIE;
+        sys.flag.delay_over = 1;
+    }
+}
 
-    // Disable IE
-    TA0CCTL0 &= ~CCIE;
-    // Reset IRQ flag
-    TA0CCTL0 &= ~CCIFG;
-    // Add 1 sec to TACCR0 register (IRQ will be asserted at 0x7FFF and 0xFFFF = 1 sec intervals)
-    TA0CCR0 += 32768;
-    // Enable IE
-    TA0CCTL0 |= CCIE;
+// *************************************************************************************************
+// @fn          timer_job_start
+// @brief       Register a job that RTC_A_ISR calls every "period" seconds. Registering an
+//                              active job again restarts its period. Jobs that are due within the
+//                              current minute keep the 1 sec clock tick enabled.
+// @param       u8 job                          Job index TIMER_JOB_xxx
+//                              void (*fptr)(void)      Job function, called in ISR context
+//                              u16 period                      Period in seconds (1 = each clock tick)
+//                              u8 type                         TIMER_JOB_PERIODIC, TIMER_JOB_ONE_SHOT
+// @return      none
+// *************************************************************************************************
+void timer_job_start(u8 job, void (*fptr)(void), u16 period, u8 type)
+{
+    u16 int_state;
+    u16 mask = 1u << job;
+    u32 now;
 
-    // Add 1 second to global time
-    clock_tick();
+    if ((job >= TIMER_JOBS) || (period == 0))
+        return;
 
-    // Set clock update flag
-    display.flag.update_time = 1;
+    // Jobs are serviced by 1 sec clock tick
+    rtc_tick_second();
 
-    // While SimpliciTI stack operates or BlueRobin searches, freeze system state
-    if (is_rf())
-    {
-        // SimpliciTI automatic timeout
-        if (sRFsmpl.timeout == 0)
-        {
-            simpliciti_flag |= SIMPLICITI_TRIGGER_STOP;
-        }
-        else
-        {
-            sRFsmpl.timeout--;
-        }
+    // Also called from ISRs - keep interrupt state
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
 
-        // switch message after received packet
-        if (sRFsmpl.mode == SIMPLICITI_SYNC)
-        {
-            if (sRFsmpl.display_sync_done == 0)
-            {
-                display_chars(LCD_SEG_L2_5_0, (u8 *) "  SYNC", SEG_ON);
-            }
-            else
-            {
-                sRFsmpl.display_sync_done--;
-            }
-        }
-        // Exit from LPM3 on RETI
-        _BIC_SR_IRQ(LPM3_bits);
-        return;
-    }
+    sTimer.job[job].fptr = fptr;
+    sTimer.job[job].period = period;
 
-    // -------------------------------------------------------------------
-    // Service modules that require 1/min processing
-    if (sTime.drawFlag >= 2)
-    {
-        // Measure battery voltage to keep track of remaining battery life
-        request.flag.voltage_measurement = 1;
+    // Countdown starts at last service - add time that has passed since
+    now = timer_now();
+    sTimer.job[job].countdown = period + timer_elapsed(now);
 
-        // Check if alarm needs to be turned on
-        check_alarm();
-    }
+    // Jobs with a period of full minutes are due with the minute tick, so they do not need the
+    // 1 sec clock tick
+    if ((period % 60) == 0)
+        sTimer.job[job].countdown -= (u16) (now % 60);
 
-    // -------------------------------------------------------------------
-    // Service active modules that require 1/s processing
+    if (type == TIMER_JOB_ONE_SHOT)
+        sTimer.jobs_one_shot |= mask;
+    else
+        sTimer.jobs_one_shot &= ~mask;
 
-    // Generate alarm signal
-    if (sAlarm.state == ALARM_ON)
-    {
-        // Decrement alarm duration counter
-        if (sAlarm.duration-- > 0)
-        {
-            request.flag.buzzer = 1;
-        }
-        else
-        {
-            sAlarm.duration = ALARM_ON_DURATION;
-            stop_alarm();
-        }
-    }
+    sTimer.jobs_active |= mask;
 
-    // Do a temperature measurement each second while menu item is active
-    if (is_temp_measurement())
-        request.flag.temperature_measurement = 1;
+    __set_interrupt_state(int_state);
+}
 
-    // Do a pressure measurement each second while menu item is active
-    if (is_altitude_measurement())
-    {
-        // Countdown altitude measurement timeout while menu item is active
-        sAlt.timeout--;
+// *************************************************************************************************
+// @fn          timer_job_stop
+// @brief       Remove job from RTC_A_ISR.
+// @param       u8 job                          Job index TIMER_JOB_xxx
+// @return      none
+// *************************************************************************************************
+void timer_job_stop(u8 job)
+{
+    u16 int_state;
 
-        // Stop measurement when timeout has elapsed
-        if (sAlt.timeout == 0)
-        {
-            stop_altitude_measurement();
-            // Show ---- m/ft
-            display_chars(LCD_SEG_L1_3_0, (u8 *) "----", SEG_ON);
-            // Clear up/down arrow
-            display_symbol(LCD_SYMB_ARROW_UP, SEG_OFF);
-            display_symbol(LCD_SYMB_ARROW_DOWN, SEG_OFF);
-        }
-        else
-        {
-            if (bmp_used)
-            {
-                bmp_ps_start();
-            }
-        }
+    if (job >= TIMER_JOBS)
+        return;
 
-        // In case we missed the IRQ due to debouncing, get data now
-        if ((PS_INT_IN & PS_INT_PIN) == PS_INT_PIN)
-            request.flag.altitude_measurement = 1;
-    }
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+    sTimer.jobs_active &= ~(1u << job);
+    __set_interrupt_state(int_state);
+}
 
-    // Count down timeout
-    if (is_acceleration_measurement())
-    {
-        // Countdown acceleration measurement timeout
-        sAccel.timeout--;
+// *************************************************************************************************
+// @fn          timer_now
+// @brief       Read time of day in seconds from RTC_A. Also valid in minute tick mode, when
+//                              sTime is only updated once a minute.
+// @param       none
+// @return      u32             Seconds since midnight
+// *************************************************************************************************
+u32 timer_now(void)
+{
+    return (rtc_get_timestamp() / RTC_TIMESTAMP_PER_SEC);
+}
 
-        // Stop measurement when timeout has elapsed
-        if (sAccel.timeout == 0)
-        {
-        	if (bmp_used)
-        	{
-            	bmp_as_stop();
-        	}
-        	else
-        	{
-                cma_as_stop();
-        	}
-            // Show ----
-            display_chars(LCD_SEG_L1_3_0, (u8 *) "----", SEG_ON);
-            // Clear up/down arrow
-            display_symbol(LCD_SYMB_ARROW_UP, SEG_OFF);
-            display_symbol(LCD_SYMB_ARROW_DOWN, SEG_OFF);
-            display_symbol(LCD_SEG_L1_DP1, SEG_OFF);
-        }
+// *************************************************************************************************
+// @fn          timer_elapsed
+// @brief       Seconds since jobs were last serviced. Jobs are serviced at least once a minute,
+//                              longer intervals are only seen after the clock was set and are
+//                              limited to 1 minute.
+// @param       u32 now         Time of day (s)
+// @return      u16             Elapsed seconds (0..60)
+// *************************************************************************************************
+u16 timer_elapsed(u32 now)
+{
+    u32 elapsed;
 
-        // If DRDY is (still) high, request data again
-        if ((AS_INT_IN & AS_INT_PIN) == AS_INT_PIN)
-            request.flag.acceleration_measurement = 1;
-    }
+    if (now >= sTimer.serviced)
+        elapsed = now - sTimer.serviced;
+    else
+        elapsed = now + (24 * 60 * 60u) - sTimer.serviced;
 
-    if ( is_counter_measurement())
-    {
-    	if ((AS_INT_IN & AS_INT_PIN) == AS_INT_PIN)
-    		request.flag.counter_measurement = 1;
-    }
+    if (elapsed > 60)
+        elapsed = 60;
 
-    // If battery is low, decrement display counter
-    if (sys.flag.low_battery)
-    {
-        if (sBatt.lobatt_display-- == 0)
-        {
-            message.flag.prepare = 1;
-            message.flag.type_lobatt = 1;
-            sBatt.lobatt_display = BATTERY_LOW_MESSAGE_CYCLE;
-        }
-    }
+    return ((u16) elapsed);
+}
 
-    // If a message has to be displayed, set display flag
-    if (message.all_flags)
+// *************************************************************************************************
+// @fn          is_second_tick_needed
+// @brief       Check if any module needs the 1 sec clock tick. Jobs are also serviced by the
+//                              minute tick, so only jobs that are due before the next full minute
+//                              need the 1 sec clock tick.
+// @param       none
+// @return      u8              1 = 1 sec clock tick needed, 0 = 1 min clock tick is sufficient
+// *************************************************************************************************
+u8 is_second_tick_needed(void)
+{
+    u8 job;
+    u16 mask;
+    u16 next_minute;
+    u32 now;
+
+    // Active SimpliciTI / BlueRobin is serviced every second
+    if (is_rf())
+        return (1);
+
+    // Seconds are on display
+    if ((ptrMenu_L1 == &menu_L1_Time) && (sTime.line1ViewStyle == DISPLAY_ALTERNATIVE_VIEW))
+        return (1);
+
+    // Seconds from last service to next minute tick
+    now = timer_now();
+    next_minute = timer_elapsed(now) + 60 - (u16) (now % 60);
+
+    // Earliest job deadline decides
+    for (job = 0, mask = 1; (job < TIMER_JOBS) && (sTimer.jobs_active >= mask); job++, mask <<= 1)
     {
-        if (message.flag.prepare)
-        {
-            message.flag.prepare = 0;
-            message.flag.show = 1;
-        }
-        else if (message.flag.erase)    // message cycle is over, so erase it
-        {
-            message.flag.erase = 0;
-            display.flag.full_update = 1;
-        }
+        if ((sTimer.jobs_active & mask) && (sTimer.job[job].countdown < next_minute))
+            return (1);
     }
 
-    // -------------------------------------------------------------------
-    // Check idle timeout, set timeout flag
-    if (sys.flag.idle_timeout_enabled)
+    return (0);
+}
+
+#ifdef USE_PROFILING
+// *************************************************************************************************
+// @fn          timer_check_tick_mode
+// @brief       Self check of minute tick mode, called by RTC_A_ISR with each minute tick. A watch
+//                              that shows HH:MM on Line1 with radio off and only jobs of 1 minute
+//                              or longer must have switched to minute tick mode by the next minute
+//                              tick. Counts violations in sProfile.tick_errors.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void timer_check_tick_mode(void)
+{
+    u8 job;
+    u16 mask;
+    u8 idle;
+
+    idle = !is_rf() && (ptrMenu_L1 == &menu_L1_Time) &&
+           (sTime.line1ViewStyle != DISPLAY_ALTERNATIVE_VIEW);
+
+    for (job = 0, mask = 1; (job < TIMER_JOBS) && (sTimer.jobs_active >= mask); job++, mask <<= 1)
     {
-        if (sTime.system_time - sTime.last_activity > INACTIVITY_TIME)
-            sys.flag.idle_timeout = 1;  //setFlag(sysFlag_g, SYS_TIMEOUT_IDLE);
+        if ((sTimer.jobs_active & mask) && (sTimer.job[job].period < 60))
+            idle = 0;
     }
 
-    // -------------------------------------------------------------------
-    // Turn the Backlight off after timeout
-    if (sButton.backlight_status == 1)
+    // Watch was idle for a whole minute but still ticks every second
+    if (idle && sProfile.tick_idle && (RTCCTL01 & RTCRDYIE))
+        sProfile.tick_errors++;
+
+    sProfile.tick_idle = idle;
+}
+#endif
+
+// *************************************************************************************************
+// @fn          timer_service_jobs
+// @brief       Call registered jobs that are due. Called by RTC_A_ISR after 1 sec clock tick, or
+//                              after minute tick while 1 sec clock tick is off. Countdowns are
+//                              decremented by the seconds elapsed since last service.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void timer_service_jobs(void)
+{
+    u8 job;
+    u16 mask;
+    u16 elapsed;
+    u32 now;
+
+    now = timer_now();
+    elapsed = timer_elapsed(now);
+    sTimer.serviced = now;
+
+    if (elapsed == 0)
+        return;
+
+    for (job = 0, mask = 1; (job < TIMER_JOBS) && (sTimer.jobs_active >= mask); job++, mask <<= 1)
     {
-        if (sButton.backlight_timeout > BACKLIGHT_TIME_ON)
+        if ((sTimer.jobs_active & mask) == 0)
+            continue;
+
+        if (sTimer.job[job].countdown > elapsed)
         {
-            //turn off Backlight
-            P2OUT &= ~BUTTON_BACKLIGHT_PIN;
-            P2DIR &= ~BUTTON_BACKLIGHT_PIN;
-            sButton.backlight_timeout = 0;
-            sButton.backlight_status = 0;
+            sTimer.job[job].countdown -= elapsed;
+            continue;
         }
+
+        // Remove one-shot job before calling it, so it can register itself again
+        if (sTimer.jobs_one_shot & mask)
+            sTimer.jobs_active &= ~mask;
         else
-        {
-            sButton.backlight_timeout++;
-        }
+            sTimer.job[job].countdown = sTimer.job[job].period;
+
+        sTimer.job[job].fptr();
     }
+}
 
-    // -------------------------------------------------------------------
-    // Detect continuous button high states
+// *************************************************************************************************
+// @fn          timer_hold_jobs
+// @brief       Skip time since last service, jobs do not count down. Called by RTC_A_ISR while
+//                              SimpliciTI / BlueRobin freeze the system state.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void timer_hold_jobs(void)
+{
+    sTimer.serviced = timer_now();
+}
 
-    // Trying to lock/unlock buttons?
-    if (BUTTON_NUM_IS_PRESSED && BUTTON_DOWN_IS_PRESSED)
-    {
-        if (button_lock_counter++ > LEFT_BUTTON_LONG_TIME)
-        {
-            // Toggle lock / unlock buttons flag
-            sys.flag.lock_buttons = ~sys.flag.lock_buttons;
-
-            // Show "buttons are locked/unlocked" message synchronously with next second tick
-            message.flag.prepare = 1;
-            if (sys.flag.lock_buttons)
-                message.flag.type_locked = 1;
-            else
-                message.flag.type_unlocked = 1;
-
-            // Reset button lock counter
-            button_lock_counter = 0;
-        }
-    }
-    else                        // Trying to create a long button press?
-    {
-        // Reset button lock counter
-        button_lock_counter = 0;
+// *************************************************************************************************
+// @fn          TIMER0_A0_ISR
+// @brief       IRQ handler for TIMER0_A0 IRQ
+//                              Timer0_A0       Button sample period
+// @param       none
+// @return      none
+// *************************************************************************************************
+#pragma vector = TIMER0_A0_VECTOR
+__interrupt void TIMER0_A0_ISR(void)
+{
+    PROFILE_ENTER();
 
-        if (BUTTON_STAR_IS_PRESSED)
-        {
-            sButton.star_timeout++;
-
-            // Check if button was held low for some seconds
-            if (sButton.star_timeout > LEFT_BUTTON_LONG_TIME)
-            {
-                button.flag.star_long = 1;
-                button.flag.star_not_long = 0;
-                sButton.star_timeout = 0;
-                // Return interrupt edge to normal value
-                BUTTONS_IES &= ~BUTTON_STAR_PIN;
-            }
-        }
-        else                    // there was a button press not long enough
-        {
-            sButton.star_timeout = 0;
-        }
+    // Disable IE and reset IRQ flag
+    TA0CCTL0 &= ~(CCIE + CCIFG);
 
-        if (BUTTON_NUM_IS_PRESSED)
-        {
-            sButton.num_timeout++;
-
-            // Check if button was held low for some seconds
-            if (sButton.num_timeout > LEFT_BUTTON_LONG_TIME)
-            {
-                button.flag.num_long = 1;
-                button.flag.num_not_long = 0;
-                sButton.num_timeout = 0;
-                // Return interrupt edge to normal value
-                BUTTONS_IES &= ~BUTTON_NUM_PIN;
-            }
-        }
-        else                    // there was a button press not long enough
-        {
-            sButton.num_timeout = 0;
-        }
-    }
+    // Detect button gestures, exit from LPM3 on RETI when there is a new button event
+    if (button_sample())
+        _BIC_SR_IRQ(LPM3_bits);
 
-    // Exit from LPM3 on RETI
-    _BIC_SR_IRQ(LPM3_bits);
+    PROFILE_EXIT(PROFILE_TIMER0_A0);
 }
 
 // *************************************************************************************************
 // @fn          Timer0_A1_5_ISR
 // @brief       IRQ handler for timer IRQ.
-//                              Timer0_A0       1/1sec clock tick (serviced by function
+//                              Timer0_A0       Button sample period (serviced by function
 // TIMER0_A0_ISR)
-//                              Timer0_A1       BlueRobin timer
+//                              Timer0_A1       Protothread delay
 //                              Timer0_A2       1/100 sec Stopwatch
-//                              Timer0_A3       Configurable periodic IRQ (used by button_repeat and
-// buzzer)
+//                              Timer0_A3       Configurable periodic IRQ (used by buzzer)
 //                              Timer0_A4       One-time delay
 // @param       none
 // @return      none
@@ -540,12 +611,17 @@ __interrupt void TIMER0_A0_ISR(void)
 __interrupt void TIMER0_A1_5_ISR(void)
 {
     u16 value = 0;
+    PROFILE_ENTER();
 
     switch (TA0IV)
     {
-        // Timer0_A1    BlueRobin timer
-        case 0x02:             // Timer0_A1 handler
-            BRRX_TimerTask_v();
+        // Timer0_A1    Protothread delay
+        case 0x02:             // Disable IE
+            TA0CCTL1 &= ~CCIE;
+            // Reset IRQ flag
+            TA0CCTL1 &= ~CCIFG;
+            // Let waiting protothread run
+            sTask.wakeup = 1;
             break;
 
         // Timer0_A2    1/1 or 1/100 sec Stopwatch
@@ -562,7 +638,7 @@ __interrupt void TIMER0_A1_5_ISR(void)
             stopwatch_tick();
             break;
 
-        // Timer0_A3    Configurable periodic IRQ (used by button_repeat and buzzer)
+        // Timer0_A3    Configurable periodic IRQ (used by buzzer)
         case 0x06:             // Disable IE
             TA0CCTL3 &= ~CCIE;
             // Reset IRQ flag
@@ -590,6 +666,8 @@ __interrupt void TIMER0_A1_5_ISR(void)
             break;
     }
 
+    PROFILE_EXIT(PROFILE_TIMER0_A1_5);
+
     // Exit from LPM3 on RETI
     _BIC_SR_IRQ(LPM3_bits);
 }
@@ -44,18 +44,73 @@
 extern void Timer0_Init(void);
 extern void Timer0_Start(void);
 extern void Timer0_Stop(void);
+extern void Timer0_A0_Start(u16 ticks);
+extern void Timer0_A1_Start(u16 ticks);
+extern void Timer0_A1_Stop(void);
+extern u8 Timer0_A1_Over(void);
 extern void Timer0_A3_Start(u16 ticks);
 extern void Timer0_A3_Stop(void);
 extern void Timer0_A4_Delay(u16 ticks);
+extern void Timer0_A4_Stop(void);
+extern void timer_job_start(u8 job, void (*fptr)(void), u16 period, u8 type);
+extern void timer_job_stop(u8 job);
+extern void timer_service_jobs(void);
+extern void timer_hold_jobs(void);
+extern u8 is_second_tick_needed(void);
+#ifdef USE_PROFILING
+extern void timer_check_tick_mode(void);
+#endif
 
 extern void (*fptr_Timer0_A3_function)(void);
 
 // *************************************************************************************************
 // Defines section
+// Jobs serviced by RTC_A_ISR after clock tick. Job index is also service order.
+#define TIMER_JOB_ALARM                 (0u)
+#define TIMER_JOB_TEMPERATURE           (1u)
+#define TIMER_JOB_ALTITUDE              (2u)
+#define TIMER_JOB_ACCELERATION          (3u)
+#define TIMER_JOB_COUNTER               (4u)
+#define TIMER_JOB_BATTERY               (5u)
+#define TIMER_JOB_MESSAGE               (6u)
+#define TIMER_JOB_IDLE_TIMEOUT          (7u)
+#define TIMER_JOB_BACKLIGHT             (8u)
+#define TIMER_JOB_TOTP                  (9u)
+#define TIMER_JOB_ALTITUDE_SESSION      (10u)
+#define TIMER_JOBS                      (11u)
+
+// Job types
+#define TIMER_JOB_PERIODIC              (0u)
+#define TIMER_JOB_ONE_SHOT              (1u)
+
+struct timer_job
+{
+    // Job function, called in RTC_A_ISR context
+    void (*fptr)(void);
+
+    // Job period in seconds
+    u16 period;
+
+    // Seconds until job is due, counted from last service
+    u16 countdown;
+};
+
 struct timer
 {
     // Timer0_A3 periodic delay
     u16 timer0_A3_ticks;
+
+    // Bit n set = job n is registered
+    u16 jobs_active;
+
+    // Bit n set = job n is removed after it was called
+    u16 jobs_one_shot;
+
+    // Registered jobs
+    struct timer_job job[TIMER_JOBS];
+
+    // Time of day (s) when jobs were last serviced
+    u32 serviced;
 };
 extern struct timer sTimer;
 
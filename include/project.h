@@ -50,6 +50,9 @@
 // Comment this define to build the application without watchdog support
 //#define USE_WATCHDOG
 
+// Uncomment this define to build the application with ISR and task run time statistics
+//#define USE_PROFILING
+
 // Use/not use filter when measuring physical values
 #define FILTER_OFF                                              (0u)
 #define FILTER_ON                                               (1u)
@@ -91,22 +94,6 @@ typedef union
 } s_system_flags;
 extern volatile s_system_flags sys;
 
-// Set of request flags
-typedef union
-{
-    struct
-    {
-        u16 temperature_measurement : 1;  // 1 = Measure temperature
-        u16 voltage_measurement : 1;      // 1 = Measure voltage
-        u16 altitude_measurement : 1;     // 1 = Measure air pressure
-        u16 acceleration_measurement : 1; // 1 = Measure acceleration
-        u16 buzzer : 1;                   // 1 = Output buzzer
-        u16 counter_measurement : 1;      // 1 = measure counter from acceleration
-    } flag;
-    u16 all_flags;                        // Shortcut to all request flags (for reset)
-} s_request_flags;
-extern volatile s_request_flags request;
-
 // Set of message flags
 typedef union
 {
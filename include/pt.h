@@ -0,0 +1,82 @@
+// *************************************************************************************************
+// Stackless protothreads. A protothread is a function that can wait for a condition and return to
+// its caller. When called again, it continues where it waited. Local variables are not kept while
+// waiting - use static or global variables instead. Do not use switch statements in a protothread
+// body, as waiting is implemented with a switch on the source line number.
+// *************************************************************************************************
+
+#ifndef PT_H_
+#define PT_H_
+
+// *************************************************************************************************
+// Include section
+
+// *************************************************************************************************
+// Prototypes section
+
+// *************************************************************************************************
+// Defines section
+
+// Protothread return values
+#define PT_WAITING                      (0u)    // Waits for condition
+#define PT_YIELDED                      (1u)    // Gave up CPU, can continue immediately
+#define PT_ENDED                        (2u)    // Reached PT_END, starts over with next call
+
+// Protothread state: source line to continue at, 0 = start
+struct pt
+{
+    u16 lc;
+};
+
+// *************************************************************************************************
+// Macro section
+
+// Start protothread from beginning
+#define PT_INIT(pt)                     ((pt)->lc = 0)
+
+// Declare protothread function
+#define PT_THREAD(name_args)            u8 name_args
+
+// Begin and end of protothread body
+#define PT_BEGIN(pt)                    { u8 pt_yield = 1; u8 pt_child; switch ((pt)->lc) { case 0:
+#define PT_END(pt)                      \
+    } (void) pt_yield; (void) pt_child; PT_INIT(pt); return (PT_ENDED); }
+
+// Return until condition is true
+#define PT_WAIT_UNTIL(pt, condition)    \
+    do { (pt)->lc = __LINE__; case __LINE__: if (!(condition)) return (PT_WAITING); } while (0)
+
+// Return once, continue with next call
+#define PT_YIELD(pt)                    \
+    do { pt_yield = 0; (pt)->lc = __LINE__; case __LINE__: if (pt_yield == 0) return (PT_YIELDED); \
+    } while (0)
+
+// Return once and let the caller go to LPM until next interrupt, continue with next call
+#define PT_SLEEP(pt)                    \
+    do { pt_yield = 0; (pt)->lc = __LINE__; case __LINE__: if (pt_yield == 0) return (PT_WAITING); \
+    } while (0)
+
+// Run child protothread until it has ended, pass on its waits and yields
+#define PT_WAIT_THREAD(pt, thread)      \
+    do { (pt)->lc = __LINE__; case __LINE__: pt_child = (thread); \
+         if (pt_child != PT_ENDED) return (pt_child); } while (0)
+
+// Start child protothread from beginning and run it until it has ended
+#define PT_SPAWN(pt, child, thread)     do { PT_INIT(child); PT_WAIT_THREAD(pt, thread); } while (0)
+
+// Leave protothread, starts over with next call
+#define PT_EXIT(pt)                     do { PT_INIT(pt); return (PT_ENDED); } while (0)
+
+// Wait for ticks of 32768Hz ACLK with Timer0_A1. Only one protothread can wait at a time.
+#define PT_DELAY(pt, ticks)             \
+    do { Timer0_A1_Start(ticks); PT_WAIT_UNTIL(pt, Timer0_A1_Over()); } while (0)
+
+// *************************************************************************************************
+// Global Variable section
+
+// *************************************************************************************************
+// Extern section
+extern void Timer0_A1_Start(u16 ticks);
+extern u8 Timer0_A1_Over(void);
+
+#endif                          /*PT_H_ */
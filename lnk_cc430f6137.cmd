@@ -37,7 +37,8 @@ MEMORY
     INFOB                   : origin = 0x1900, length = 0x0080
     INFOC                   : origin = 0x1880, length = 0x0080
     INFOD                   : origin = 0x1800, length = 0x0080
-    FLASH                   : origin = 0x8000, length = 0x7F80
+    LOGGER                  : origin = 0x8000, length = 0x0800
+    FLASH                   : origin = 0x8800, length = 0x7780
     INT00                   : origin = 0xFF80, length = 0x0002
     INT01                   : origin = 0xFF82, length = 0x0002
     INT02                   : origin = 0xFF84, length = 0x0002
@@ -110,9 +111,11 @@ MEMORY
 
 SECTIONS
 {
-    .bss       : {} > RAM                /* GLOBAL & STATIC VARS              */
+    .bss       : {} > RAM,               /* GLOBAL & STATIC VARS              */
+                    START(_ram_bss_start), END(_ram_bss_end)
     .sysmem    : {} > RAM                /* DYNAMIC MEMORY ALLOCATION AREA    */
-    .stack     : {} > RAM (HIGH)         /* SOFTWARE SYSTEM STACK             */
+    .stack     : {} > RAM (HIGH),        /* SOFTWARE SYSTEM STACK             */
+                    START(_ram_stack_start), END(_ram_stack_end)
 
     .text      : {} > FLASH              /* CODE                              */
     .cinit     : {} > FLASH              /* INITIALIZATION TABLES             */
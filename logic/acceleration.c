@@ -46,6 +46,8 @@
 #include "bmp_as.h"
 #include "cma_as.h"
 #include "as.h"
+#include "timer.h"
+#include "event.h"
 
 // logic
 #include "acceleration.h"
@@ -185,6 +187,43 @@ void do_acceleration_measurement(void)
     display.flag.update_acceleration = 1;
 }
 
+// *************************************************************************************************
+// @fn          tick_acceleration
+// @brief       Timer job while acceleration is measured. Stops sensor when timeout has elapsed.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void tick_acceleration(void)
+{
+    // Countdown acceleration measurement timeout
+    sAccel.timeout--;
+
+    // Stop measurement when timeout has elapsed
+    if (sAccel.timeout == 0)
+    {
+    	if (bmp_used)
+    	{
+        	bmp_as_stop();
+    	}
+    	else
+    	{
+            cma_as_stop();
+    	}
+        timer_job_stop(TIMER_JOB_ACCELERATION);
+
+        // Show ----
+        display_bitmap(&lcd_bmp_l1_dashes, SEG_ON);
+        // Clear up/down arrow
+        display_symbol(LCD_SYMB_ARROW_UP, SEG_OFF);
+        display_symbol(LCD_SYMB_ARROW_DOWN, SEG_OFF);
+        display_symbol(LCD_SEG_L1_DP1, SEG_OFF);
+    }
+
+    // If DRDY is (still) high, request data again
+    if ((AS_INT_IN & AS_INT_PIN) == AS_INT_PIN)
+        event_post(EVENT_ACCELERATION_MEASUREMENT, 0);
+}
+
 // *************************************************************************************************
 // @fn          display_acceleration
 // @brief       Display routine.
@@ -231,6 +270,10 @@ void display_acceleration(u8 line, u8 update)
                     // Set mode
                     sAccel.mode = ACCEL_MODE_ON;
 
+                    // Count down timeout each second
+                    timer_job_start(TIMER_JOB_ACCELERATION, tick_acceleration, 1,
+                                    TIMER_JOB_PERIODIC);
+
                     // Start with Y-axis values
                     sAccel.view_style = DISPLAY_ACCEL_Y;
                 }
@@ -295,6 +338,7 @@ void display_acceleration(u8 line, u8 update)
 
             // Clear mode
             sAccel.mode = ACCEL_MODE_OFF;
+            timer_job_stop(TIMER_JOB_ACCELERATION);
 
             // Clean up display
             display_symbol(LCD_SEG_L1_DP1, SEG_OFF);
@@ -73,5 +73,6 @@ extern void sx_acceleration(u8 line);
 extern void display_acceleration(u8 line, u8 update);
 extern u8 is_acceleration_measurement(void);
 extern void do_acceleration_measurement(void);
+extern void tick_acceleration(void);
 
 #endif                          /*ACCELERATION_H_ */
@@ -45,6 +45,10 @@
 #include "display.h"
 #include "buzzer.h"
 #include "ports.h"
+#include "timer.h"
+#include "rtc.h"
+#include "event.h"
+#include "task.h"
 
 // logic
 #include "alarm.h"
@@ -53,6 +57,7 @@
 
 // *************************************************************************************************
 // Prototypes section
+PT_THREAD(mx_alarm_flow(struct pt *pt));
 
 // *************************************************************************************************
 // Defines section
@@ -63,6 +68,7 @@ struct alarm sAlarm;
 
 // *************************************************************************************************
 // Extern section
+extern void tick_message(void);
 
 // *************************************************************************************************
 // @fn          reset_alarm
@@ -75,6 +81,7 @@ void reset_alarm(void)
     // Default alarm time 06:30
     sAlarm.hour = 06;
     sAlarm.minute = 30;
+    rtc_set_alarm(sAlarm.hour, sAlarm.minute);
 
     // Alarm is initially off
     sAlarm.duration = ALARM_ON_DURATION;
@@ -83,7 +90,8 @@ void reset_alarm(void)
 
 // *************************************************************************************************
 // @fn          check_alarm
-// @brief       Check if current time matches alarm time
+// @brief       Turn alarm on if it is enabled. Called by RTC alarm IRQ when current time matches
+//                              alarm time.
 // @param       none
 // @return      none
 // *************************************************************************************************
@@ -93,16 +101,11 @@ void check_alarm(void)
     if (sAlarm.state != ALARM_ENABLED)
         return;
 
-    // Compare current time and alarm time
-    // Start with minutes - only 1/60 probability to match
-    if (sTime.minute == sAlarm.minute)
-    {
-        if (sTime.hour == sAlarm.hour)
-        {
-            // Indicate that alarm is on
-            sAlarm.state = ALARM_ON;
-        }
-    }
+    // Indicate that alarm is on
+    sAlarm.state = ALARM_ON;
+
+    // Generate alarm signal each second
+    timer_job_start(TIMER_JOB_ALARM, tick_alarm, 1, TIMER_JOB_PERIODIC);
 }
 
 // *************************************************************************************************
@@ -116,10 +119,34 @@ void stop_alarm(void)
     // Indicate that alarm is enabled, but not active
     sAlarm.state = ALARM_ENABLED;
 
+    // Stop alarm signal
+    timer_job_stop(TIMER_JOB_ALARM);
+
     // Stop buzzer
     stop_buzzer();
 }
 
+// *************************************************************************************************
+// @fn          tick_alarm
+// @brief       Timer job while alarm is on. Generates alarm signal until alarm duration is over.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void tick_alarm(void)
+{
+    // Decrement alarm duration counter
+    if (sAlarm.duration-- > 0)
+    {
+        // Two signals every second
+        event_post(EVENT_BUZZER, 2);
+    }
+    else
+    {
+        sAlarm.duration = ALARM_ON_DURATION;
+        stop_alarm();
+    }
+}
+
 // *************************************************************************************************
 // @fn          sx_alarm
 // @brief       Sx button turns alarm on/off.
@@ -139,6 +166,7 @@ void sx_alarm(u8 line)
             // Show "  on" message
             message.flag.prepare = 1;
             message.flag.type_alarm_on = 1;
+            timer_job_start(TIMER_JOB_MESSAGE, tick_message, 1, TIMER_JOB_PERIODIC);
         }
         else if (sAlarm.state == ALARM_ENABLED)
         {
@@ -147,23 +175,37 @@ void sx_alarm(u8 line)
             // Show "  off" message
             message.flag.prepare = 1;
             message.flag.type_alarm_off = 1;
+            timer_job_start(TIMER_JOB_MESSAGE, tick_message, 1, TIMER_JOB_PERIODIC);
         }
     }
 }
 
 // *************************************************************************************************
 // @fn          mx_alarm
-// @brief       Set alarm time.
+// @brief       Set alarm time. Runs as foreground flow mx_alarm_flow().
 // @param       u8 line LINE1
 // @return      none
 // *************************************************************************************************
 void mx_alarm(u8 line)
 {
-    u8 select;
-    s32 hours;
-    s32 minutes;
+    task_flow_start(mx_alarm_flow);
+}
+
+// *************************************************************************************************
+// @fn          mx_alarm_flow
+// @brief       Alarm set flow.
+// @param       struct pt *pt   Protothread state
+// @return      u8              PT_WAITING, PT_ENDED
+// *************************************************************************************************
+PT_THREAD(mx_alarm_flow(struct pt *pt))
+{
+    static u8 select;
+    static s32 hours;
+    static s32 minutes;
     u8 *str;
 
+    PT_BEGIN(pt);
+
     // Clear display
     clear_display_all();
 
@@ -195,26 +237,28 @@ void mx_alarm(u8 line)
             // Store local variables in global alarm time
             sAlarm.hour = hours;
             sAlarm.minute = minutes;
+            rtc_set_alarm(sAlarm.hour, sAlarm.minute);
             // Set display update flag
             display.flag.line1_full_update = 1;
             break;
         }
 
-        switch (select)
+        // No switch statement - set_value() waits
+        if (select == 0)
+        {
+            // Set hour
+            PT_SPAWN(pt, &sSetValue.pt, set_value(
+                &sSetValue.pt, &hours, 2, 0, 0, 23, SETVALUE_ROLLOVER_VALUE +
+                SETVALUE_DISPLAY_VALUE + SETVALUE_NEXT_VALUE, LCD_SEG_L1_3_2, display_hours));
+            select = 1;
+        }
+        else
         {
-            case 0:            // Set hour
-                set_value(&hours, 2, 0, 0, 23, SETVALUE_ROLLOVER_VALUE + SETVALUE_DISPLAY_VALUE +
-                          SETVALUE_NEXT_VALUE, LCD_SEG_L1_3_2,
-                          display_hours);
-                select = 1;
-                break;
-
-            case 1:            // Set minutes
-                set_value(&minutes, 2, 0, 0, 59, SETVALUE_ROLLOVER_VALUE + SETVALUE_DISPLAY_VALUE +
-                          SETVALUE_NEXT_VALUE, LCD_SEG_L1_1_0,
-                          display_value);
-                select = 0;
-                break;
+            // Set minutes
+            PT_SPAWN(pt, &sSetValue.pt, set_value(
+                &sSetValue.pt, &minutes, 2, 0, 0, 59, SETVALUE_ROLLOVER_VALUE +
+                SETVALUE_DISPLAY_VALUE + SETVALUE_NEXT_VALUE, LCD_SEG_L1_1_0, display_value));
+            select = 0;
         }
     }
 
@@ -223,6 +267,8 @@ void mx_alarm(u8 line)
 
     // Indicate to display function that new value is available
     display.flag.update_alarm = 1;
+
+    PT_END(pt);
 }
 
 // *************************************************************************************************
@@ -43,6 +43,7 @@
 extern void reset_alarm(void);
 extern void check_alarm(void);
 extern void stop_alarm(void);
+extern void tick_alarm(void);
 
 // menu functions
 extern void sx_alarm(u8 line);
@@ -50,12 +50,20 @@
 #include "cma_ps.h"
 #include "ports.h"
 #include "timer.h"
+#include "event.h"
+#include "power.h"
+#include "task.h"
 
 // logic
 #include "user.h"
 
 // *************************************************************************************************
 // Prototypes section
+void display_altitude_session_value(u8 label, s32 value);
+void altitude_sensor_on(void);
+void altitude_sensor_off(void);
+void altitude_conversion_done(void);
+PT_THREAD(mx_altitude_flow(struct pt *pt));
 
 // *************************************************************************************************
 // Defines section
@@ -63,6 +71,7 @@
 // *************************************************************************************************
 // Global Variable section
 struct alt sAlt;
+struct alt_session sAltSession;
 
 // *************************************************************************************************
 // Extern section
@@ -78,9 +87,15 @@ void reset_altitude_measurement(void)
     // Menu item is not visible
     sAlt.state = MENU_ITEM_NOT_VISIBLE;
 
+    // Start a new altitude session
+    reset_altitude_session();
+
     // Clear timeout counter
     sAlt.timeout = 0;
 
+    // No single conversion pending
+    sAlt.notify = 0;
+
     // Set default altitude value
     sAlt.altitude = 0;
 
@@ -154,23 +169,14 @@ void start_altitude_measurement(void)
     // Start altitude measurement if timeout has elapsed
     if (sAlt.timeout == 0)
     {
-        // Enable EOC IRQ on rising edge
-    	PS_INT_IFG &= ~PS_INT_PIN;
-    	PS_INT_IE |= PS_INT_PIN;
-
-        // Start pressure sensor
-    	if (bmp_used)
-    	{
-            bmp_ps_start();
-    	}
-    	else
-    	{
-            cma_ps_start();
-    	}
+        altitude_sensor_on();
 
         // Set timeout counter only if sensor status was OK
         sAlt.timeout = ALTITUDE_MEASUREMENT_TIMEOUT;
 
+        // Restart sensor and count down timeout each second
+        timer_job_start(TIMER_JOB_ALTITUDE, tick_altitude, 1, TIMER_JOB_PERIODIC);
+
         // Get updated altitude
         while ((PS_INT_IN & PS_INT_PIN) == 0) ;
         do_altitude_measurement(FILTER_OFF);
@@ -189,22 +195,149 @@ void stop_altitude_measurement(void)
     if (!ps_ok)
         return;
 
+    altitude_sensor_off();
+
+    // Clear timeout counter
+    sAlt.timeout = 0;
+
+    timer_job_stop(TIMER_JOB_ALTITUDE);
+
+    // Sensor is off - a pending single conversion will not finish, deliver last value
+    altitude_conversion_done();
+}
+
+// *************************************************************************************************
+// @fn          altitude_sensor_on
+// @brief       Start pressure sensor and enable its EOC IRQ.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void altitude_sensor_on(void)
+{
+    // Enable EOC IRQ on rising edge
+    PS_INT_IFG &= ~PS_INT_PIN;
+    PS_INT_IE |= PS_INT_PIN;
+
+    // Start pressure sensor
+    if (bmp_used)
+    {
+        bmp_ps_start();
+    }
+    else
+    {
+        cma_ps_start();
+    }
+    power_on(POWER_PRESSURE);
+}
+
+// *************************************************************************************************
+// @fn          altitude_sensor_off
+// @brief       Stop pressure sensor and disable its EOC IRQ.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void altitude_sensor_off(void)
+{
     // Stop pressure sensor
-	if (bmp_used)
-	{
+    if (bmp_used)
+    {
         bmp_ps_stop();
-	}
-	else
-	{
+    }
+    else
+    {
         cma_ps_stop();
-	}
+    }
+    power_off(POWER_PRESSURE);
 
     // Disable DRDY IRQ
     PS_INT_IE &= ~PS_INT_PIN;
     PS_INT_IFG &= ~PS_INT_PIN;
+}
 
-    // Clear timeout counter
-    sAlt.timeout = 0;
+// *************************************************************************************************
+// @fn          start_altitude_conversion
+// @brief       Request an up-to-date altitude without waiting. While Line1 measures altitude the
+//                              current value is used, otherwise a single conversion is started.
+//                              Line1 measurement state (timeout, timer job) is not changed.
+//                              When the conversion is done, the given event is posted with
+//                              parameter ALTITUDE_CONVERSION_DONE.
+// @param       u8 event        Event type EVENT_xxx to post when conversion is done
+// @return      u8              1 = conversion started, 0 = sAlt.altitude can be used now
+// *************************************************************************************************
+u8 start_altitude_conversion(u8 event)
+{
+    if (!ps_ok || (sAlt.timeout > 0))
+        return (0);
+
+    // Start sensor unless a single conversion is already running
+    if (sAlt.notify == 0)
+        altitude_sensor_on();
+    sAlt.notify |= 1u << event;
+
+    return (1);
+}
+
+// *************************************************************************************************
+// @fn          altitude_conversion_done
+// @brief       Single conversion has finished (or was cancelled). Stop sensor unless Line1
+//                              measures altitude, post events of waiting modules.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void altitude_conversion_done(void)
+{
+    u8 event;
+
+    if (sAlt.notify == 0)
+        return;
+
+    if (sAlt.timeout == 0)
+        altitude_sensor_off();
+
+    for (event = 0; event < EVENT_TYPES; event++)
+    {
+        if (sAlt.notify & (1u << event))
+            event_post(event, ALTITUDE_CONVERSION_DONE);
+    }
+    sAlt.notify = 0;
+}
+
+// *************************************************************************************************
+// @fn          tick_altitude
+// @brief       Timer job while altitude measurement is ongoing. Counts down measurement timeout.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void tick_altitude(void)
+{
+    // Measurement is only done while menu item is active
+    if (!is_altitude_measurement())
+        return;
+
+    // Countdown altitude measurement timeout while menu item is active
+    sAlt.timeout--;
+
+    // Stop measurement when timeout has elapsed
+    if (sAlt.timeout == 0)
+    {
+        stop_altitude_measurement();
+        // Show ---- m/ft
+        display_bitmap(&lcd_bmp_l1_dashes, SEG_ON);
+        // Clear up/down arrow
+        display_symbol(LCD_SYMB_ARROW_UP, SEG_OFF);
+        display_symbol(LCD_SYMB_ARROW_DOWN, SEG_OFF);
+    }
+    else
+    {
+        if (bmp_used)
+        {
+            bmp_ps_start();
+        }
+    }
+
+    // In case we missed the IRQ due to debouncing, get data now
+    if ((PS_INT_IN & PS_INT_PIN) == PS_INT_PIN)
+        event_post(EVENT_ALTITUDE_MEASUREMENT, FILTER_ON);
 }
 
 // *************************************************************************************************
@@ -246,8 +379,8 @@ void do_altitude_measurement(u8 filter)
         pressure = cma_ps_get_pa();
 	}
 
-    // Store measured pressure value
-    if (filter == FILTER_OFF)   //sAlt.pressure == 0)
+    // Store measured pressure value - single conversions are minutes apart, do not filter them
+    if ((filter == FILTER_OFF) || (sAlt.notify != 0))   //sAlt.pressure == 0)
     {
         sAlt.pressure = pressure;
     }
@@ -262,6 +395,9 @@ void do_altitude_measurement(u8 filter)
 
     // Convert pressure (Pa) and temperature (K) to altitude (m)
     sAlt.altitude = conv_pa_to_meter(sAlt.pressure, sAlt.temperature);
+
+    // Deliver result of single conversion
+    altitude_conversion_done();
 }
 
 // *************************************************************************************************
@@ -278,14 +414,28 @@ void sx_altitude(u8 line)
 
 // *************************************************************************************************
 // @fn          mx_altitude
-// @brief       Mx button handler to set the altitude offset.
+// @brief       Mx button handler to set the altitude offset. Runs as foreground flow
+//                              mx_altitude_flow().
 // @param       u8 line         LINE1
 // @return      none
 // *************************************************************************************************
 void mx_altitude(u8 line)
 {
-    s32 altitude;
-    s32 limit_high, limit_low;
+    task_flow_start(mx_altitude_flow);
+}
+
+// *************************************************************************************************
+// @fn          mx_altitude_flow
+// @brief       Altitude offset set flow.
+// @param       struct pt *pt   Protothread state
+// @return      u8              PT_WAITING, PT_ENDED
+// *************************************************************************************************
+PT_THREAD(mx_altitude_flow(struct pt *pt))
+{
+    static s32 altitude;
+    static s32 limit_high, limit_low;
+
+    PT_BEGIN(pt);
 
     // Clear display
     clear_display_all();
@@ -336,6 +486,9 @@ void mx_altitude(u8 line)
             // Update pressure table
             update_pressure_table((s16) altitude, sAlt.pressure, sAlt.temperature);
 
+            // Do not count the offset correction as climb
+            rebase_altitude_session((s16) altitude);
+
             // Set display update flag
             display.flag.line1_full_update = 1;
 
@@ -343,13 +496,15 @@ void mx_altitude(u8 line)
         }
 
         // Set current altitude - offset is set when leaving function
-        set_value(&altitude, 4, 3, limit_low, limit_high, SETVALUE_DISPLAY_VALUE +
-                  SETVALUE_FAST_MODE + SETVALUE_DISPLAY_ARROWS, LCD_SEG_L1_3_0,
-                  display_value);
+        PT_SPAWN(pt, &sSetValue.pt, set_value(
+            &sSetValue.pt, &altitude, 4, 3, limit_low, limit_high, SETVALUE_DISPLAY_VALUE +
+            SETVALUE_FAST_MODE + SETVALUE_DISPLAY_ARROWS, LCD_SEG_L1_3_0, display_value));
     }
 
     // Clear button flags
     button.all_flags = 0;
+
+    PT_END(pt);
 }
 
 // *************************************************************************************************
@@ -451,3 +606,269 @@ void display_altitude(u8 line, u8 update)
     }
 }
 
+
+// *************************************************************************************************
+// @fn          tick_altitude_session
+// @brief       Timer job while altitude session is recorded. Requests next session sample.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void tick_altitude_session(void)
+{
+    sAltSession.duration += ALTITUDE_SESSION_INTERVAL;
+
+    event_post(EVENT_ALTITUDE_SESSION, 0);
+}
+
+// *************************************************************************************************
+// @fn          sample_altitude_session
+// @brief       Event handler for EVENT_ALTITUDE_SESSION. Adds current altitude to session
+//                              statistics. Uses ongoing measurement while altitude is shown on
+//                              Line1, otherwise starts a single conversion and adds its result
+//                              when the event is posted again.
+// @param       u8 param        0 = sample is due, ALTITUDE_CONVERSION_DONE = conversion done
+// @return      none
+// *************************************************************************************************
+void sample_altitude_session(u8 param)
+{
+    // Session may have been stopped while event was queued
+    if (!sAltSession.active || !ps_ok)
+        return;
+
+    if ((param != ALTITUDE_CONVERSION_DONE) && start_altitude_conversion(EVENT_ALTITUDE_SESSION))
+        return;
+
+    update_altitude_session(sAlt.altitude);
+}
+
+// *************************************************************************************************
+// @fn          reset_altitude_session
+// @brief       Clear altitude session statistics. Next sample starts a new session.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void reset_altitude_session(void)
+{
+    sAltSession.reference = 0;
+    sAltSession.max = 0;
+    sAltSession.min = 0;
+    sAltSession.ascent = 0;
+    sAltSession.descent = 0;
+    sAltSession.sum = 0;
+    sAltSession.samples = 0;
+    sAltSession.duration = 0;
+}
+
+// *************************************************************************************************
+// @fn          update_altitude_session
+// @brief       Add one altitude sample to session statistics. Climb and descent are only
+//                              accumulated after the altitude has moved by more than
+//                              ALTITUDE_SESSION_HYSTERESIS from the last reference point, so
+//                              sensor noise does not add up. Constant cost per sample.
+// @param       s16 altitude    Altitude (m)
+// @return      none
+// *************************************************************************************************
+void update_altitude_session(s16 altitude)
+{
+    // First sample of session initialises all values
+    if (sAltSession.samples == 0)
+    {
+        sAltSession.reference = altitude;
+        sAltSession.max = altitude;
+        sAltSession.min = altitude;
+    }
+    else
+    {
+        // Track extreme values
+        if (altitude > sAltSession.max)
+            sAltSession.max = altitude;
+        if (altitude < sAltSession.min)
+            sAltSession.min = altitude;
+
+        // Accumulate climb / descent once hysteresis band has been left
+        if (altitude >= sAltSession.reference + (s16) ALTITUDE_SESSION_HYSTERESIS)
+        {
+            sAltSession.ascent += altitude - sAltSession.reference;
+            sAltSession.reference = altitude;
+        }
+        else if (altitude <= sAltSession.reference - (s16) ALTITUDE_SESSION_HYSTERESIS)
+        {
+            sAltSession.descent += sAltSession.reference - altitude;
+            sAltSession.reference = altitude;
+        }
+    }
+
+    // Sum up samples for average altitude - division is only done when value is displayed
+    sAltSession.sum += altitude;
+    sAltSession.samples++;
+}
+
+// *************************************************************************************************
+// @fn          rebase_altitude_session
+// @brief       Move climb reference point after the altitude offset was changed by the user or
+//                              the access point, so the jump is not counted as ascent or descent.
+// @param       s16 altitude    New altitude (m)
+// @return      none
+// *************************************************************************************************
+void rebase_altitude_session(s16 altitude)
+{
+    sAltSession.reference = altitude;
+}
+
+// *************************************************************************************************
+// @fn          get_altitude_session_average
+// @brief       Return average altitude of current session.
+// @param       none
+// @return      s16             Average altitude (m)
+// *************************************************************************************************
+s16 get_altitude_session_average(void)
+{
+    if (sAltSession.samples == 0)
+        return (0);
+
+    return ((s16) (sAltSession.sum / (s32) sAltSession.samples));
+}
+
+// *************************************************************************************************
+// @fn          sx_altitude_session
+// @brief       Altitude session direct function. Button DOWN cycles through views.
+// @param       u8 line         LINE2
+// @return      none
+// *************************************************************************************************
+void sx_altitude_session(u8 line)
+{
+    // Go to next view
+    if (++sAltSession.view >= ALTITUDE_SESSION_VIEWS)
+        sAltSession.view = ALTITUDE_SESSION_VIEW_ASCENT;
+}
+
+// *************************************************************************************************
+// @fn          mx_altitude_session
+// @brief       Altitude session sub menu function. Long NUM press starts a new session or
+//                              stops the running one. Session continues in background.
+// @param       u8 line         LINE2
+// @return      none
+// *************************************************************************************************
+void mx_altitude_session(u8 line)
+{
+    if (sAltSession.active)
+    {
+        // Stop recording, keep values for display and SYNC
+        timer_job_stop(TIMER_JOB_ALTITUDE_SESSION);
+        sAltSession.active = 0;
+        display_symbol(LCD_ICON_RECORD, SEG_OFF);
+    }
+    else
+    {
+        // Start new session and take first sample right away
+        reset_altitude_session();
+        sAltSession.active = 1;
+        timer_job_start(TIMER_JOB_ALTITUDE_SESSION, tick_altitude_session,
+                        ALTITUDE_SESSION_INTERVAL, TIMER_JOB_PERIODIC);
+        event_post(EVENT_ALTITUDE_SESSION, 0);
+        display_symbol(LCD_ICON_RECORD, SEG_ON);
+    }
+}
+
+// *************************************************************************************************
+// @fn          display_altitude_session_value
+// @brief       Display a label character and an altitude in xxxx m/ft format on LINE2.
+// @param       u8 label                Character shown in front of value
+//                              s32 value               Altitude (m)
+// @return      none
+// *************************************************************************************************
+void display_altitude_session_value(u8 label, s32 value)
+{
+    u8 *str;
+
+    // Convert from meters to feet (totals can exceed range of convert_m_to_ft)
+    if (!sys.flag.use_metric_units)
+        value = (value * 328) / 100;
+
+    // Limit to 4 digits, negative values use one digit for sign
+    if (value > 9999)
+        value = 9999;
+    if (value < -999)
+        value = -999;
+
+    display_char(LCD_SEG_L2_4, label, SEG_ON);
+    if (value >= 0)
+    {
+        str = int_to_array(value, 4, 3);
+        display_chars(LCD_SEG_L2_3_0, str, SEG_ON);
+    }
+    else
+    {
+        str = int_to_array(value * (-1), 3, 2);
+        display_char(LCD_SEG_L2_3, '-', SEG_ON);
+        display_chars(LCD_SEG_L2_2_0, str, SEG_ON);
+    }
+}
+
+// *************************************************************************************************
+// @fn          display_altitude_session
+// @brief       Display routine for altitude session statistics. Each value has a label
+//                              character, TOTAL symbol is shown for climb totals.
+// @param       u8 line                 LINE2
+//                              u8 update               DISPLAY_LINE_UPDATE_FULL,
+// DISPLAY_LINE_UPDATE_PARTIAL, DISPLAY_LINE_CLEAR
+// @return      none
+// *************************************************************************************************
+void display_altitude_session(u8 line, u8 update)
+{
+    u32 minutes;
+
+    if ((update == DISPLAY_LINE_UPDATE_FULL) || (update == DISPLAY_LINE_UPDATE_PARTIAL))
+    {
+        // Set view-specific symbol
+        display_symbol(LCD_SYMB_TOTAL, ((sAltSession.view == ALTITUDE_SESSION_VIEW_ASCENT) ||
+                                        (sAltSession.view == ALTITUDE_SESSION_VIEW_DESCENT)) ?
+                       SEG_ON : SEG_OFF);
+        display_symbol(LCD_SEG_L2_COL0, (sAltSession.view == ALTITUDE_SESSION_VIEW_DURATION) ?
+                       SEG_ON : SEG_OFF);
+
+        switch (sAltSession.view)
+        {
+            case ALTITUDE_SESSION_VIEW_ASCENT:
+                // Display total ascent in "u xxxx" format
+                display_altitude_session_value('U', sAltSession.ascent);
+                break;
+
+            case ALTITUDE_SESSION_VIEW_DESCENT:
+                // Display total descent in "d xxxx" format
+                display_altitude_session_value('D', sAltSession.descent);
+                break;
+
+            case ALTITUDE_SESSION_VIEW_MAX:
+                // Display highest altitude in "h xxxx" format
+                display_altitude_session_value('H', sAltSession.max);
+                break;
+
+            case ALTITUDE_SESSION_VIEW_MIN:
+                // Display lowest altitude in "l xxxx" format
+                display_altitude_session_value('L', sAltSession.min);
+                break;
+
+            case ALTITUDE_SESSION_VIEW_AVERAGE:
+                // Display average altitude in "a xxxx" format
+                display_altitude_session_value('A', get_altitude_session_average());
+                break;
+
+            case ALTITUDE_SESSION_VIEW_DURATION:
+                // Display session duration in "HH:MM" format, limit to 99:59
+                minutes = sAltSession.duration / 60;
+                if (minutes > (99 * 60 + 59))
+                    minutes = 99 * 60 + 59;
+                display_char(LCD_SEG_L2_4, ' ', SEG_ON);
+                display_chars(LCD_SEG_L2_3_2, int_to_array(minutes / 60, 2, 0), SEG_ON);
+                display_chars(LCD_SEG_L2_1_0, int_to_array(minutes % 60, 2, 0), SEG_ON);
+                break;
+        }
+    }
+    else if (update == DISPLAY_LINE_CLEAR)
+    {
+        // Clean up function-specific segments before leaving function
+        display_symbol(LCD_SYMB_TOTAL, SEG_OFF);
+        display_symbol(LCD_SEG_L2_COL0, SEG_OFF);
+    }
+}
@@ -46,17 +46,48 @@ extern u8 is_altitude_measurement(void);
 extern void start_altitude_measurement(void);
 extern void stop_altitude_measurement(void);
 extern void do_altitude_measurement(u8 filter);
+extern u8 start_altitude_conversion(u8 event);
+extern void tick_altitude(void);
 
 // menu functions
 extern void sx_altitude(u8 line);
 extern void mx_altitude(u8 line);
 extern void display_altitude(u8 line, u8 update);
 
+// altitude session functions
+extern void tick_altitude_session(void);
+extern void sample_altitude_session(u8 param);
+extern void reset_altitude_session(void);
+extern void update_altitude_session(s16 altitude);
+extern void rebase_altitude_session(s16 altitude);
+extern s16 get_altitude_session_average(void);
+extern void sx_altitude_session(u8 line);
+extern void mx_altitude_session(u8 line);
+extern void display_altitude_session(u8 line, u8 update);
+
 // *************************************************************************************************
 // Defines section
 #define ALTITUDE_MEASUREMENT_TIMEOUT    (60 * 60u) // Stop altitude measurement after 60 minutes to
                                                    // save battery
 
+// Altitude change (m) required before a climb or descent is added to the session totals
+#define ALTITUDE_SESSION_HYSTERESIS     (5u)
+
+// Event parameter: single conversion requested with start_altitude_conversion() is done
+#define ALTITUDE_CONVERSION_DONE        (1u)
+
+// Seconds between two altitude session samples
+#define ALTITUDE_SESSION_INTERVAL       (60u)
+
+// Altitude session views (Line2)
+#define ALTITUDE_SESSION_VIEW_ASCENT    (0u)
+#define ALTITUDE_SESSION_VIEW_DESCENT   (1u)
+#define ALTITUDE_SESSION_VIEW_MAX       (2u)
+#define ALTITUDE_SESSION_VIEW_MIN       (3u)
+#define ALTITUDE_SESSION_VIEW_AVERAGE   (4u)
+#define ALTITUDE_SESSION_VIEW_DURATION  (5u)
+#define ALTITUDE_SESSION_VIEWS          (6u)
+
 // *************************************************************************************************
 // Global Variable section
 struct alt
@@ -67,9 +98,26 @@ struct alt
     s16 altitude;                                  // Altitude (m)
     s16 altitude_offset;                           // Altitude offset stored during calibration
     u16 timeout;                                   // Timeout
+    u16 notify;                                    // Bit n set = post event n when single
+                                                   // conversion is done
 };
 extern struct alt sAlt;
 
+struct alt_session
+{
+    u8 view;                                       // ALTITUDE_SESSION_VIEW_xxx
+    u8 active;                                     // 1 = session is recorded
+    s16 reference;                                 // Last altitude where a climb was accounted
+    s16 max;                                       // Highest altitude (m)
+    s16 min;                                       // Lowest altitude (m)
+    u16 ascent;                                    // Total ascent (m)
+    u16 descent;                                   // Total descent (m)
+    s32 sum;                                       // Sum of all samples for average altitude
+    u32 samples;                                   // Number of samples in session
+    u32 duration;                                  // Seconds since session start
+};
+extern struct alt_session sAltSession;
+
 // *************************************************************************************************
 // Extern section
 
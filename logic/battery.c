@@ -45,6 +45,8 @@
 #include "display.h"
 #include "ports.h"
 #include "adc12.h"
+#include "timer.h"
+#include "power.h"
 
 // logic
 #include "menu.h"
@@ -54,6 +56,9 @@
 // Prototypes section
 void reset_batt_measurement(void);
 void battery_measurement(void);
+void tick_battery(void);
+void sx_battery(u8 line);
+void display_battery_V(u8 line, u8 update);
 
 // *************************************************************************************************
 // Defines section
@@ -65,6 +70,7 @@ struct batt sBatt;
 // *************************************************************************************************
 // Extern section
 extern void (*fptr_lcd_function_line2)(u8 line, u8 update);
+extern void tick_message(void);
 
 // *************************************************************************************************
 // @fn          reset_temp_measurement
@@ -77,11 +83,11 @@ void reset_batt_measurement(void)
     // Set flag to off
     sBatt.state = MENU_ITEM_NOT_VISIBLE;
 
-    // Reset lobatt display counter
-    sBatt.lobatt_display = BATTERY_LOW_MESSAGE_CYCLE;
-
     // Start with battery voltage of 3.00V
     sBatt.voltage = 300;
+
+    // Show battery voltage
+    sBatt.view = BATTERY_VIEW_VOLTAGE;
 }
 
 // *************************************************************************************************
@@ -118,6 +124,12 @@ void battery_measurement(void)
     // display function pointer
     if (sBatt.voltage < BATTERY_LOW_THRESHOLD)
     {
+        // Show "lobatt" message periodically - measurement is repeated every minute, so only
+        // start job when battery gets low
+        if (!sys.flag.low_battery)
+            timer_job_start(TIMER_JOB_BATTERY, tick_battery, BATTERY_LOW_MESSAGE_CYCLE,
+                            TIMER_JOB_PERIODIC);
+
         sys.flag.low_battery = 1;
 
         // Set sticky battery icon
@@ -126,6 +138,7 @@ void battery_measurement(void)
     else
     {
         sys.flag.low_battery = 0;
+        timer_job_stop(TIMER_JOB_BATTERY);
 
         // Clear sticky battery icon
         display_symbol(LCD_SYMB_BATTERY, SEG_OFF);
@@ -137,38 +150,90 @@ void battery_measurement(void)
     display.flag.update_battery_voltage = 1;
 }
 
+// *************************************************************************************************
+// @fn          tick_battery
+// @brief       Timer job while battery is low, called every BATTERY_LOW_MESSAGE_CYCLE seconds.
+//                              Shows "lobatt" message.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void tick_battery(void)
+{
+    message.flag.prepare = 1;
+    message.flag.type_lobatt = 1;
+    timer_job_start(TIMER_JOB_MESSAGE, tick_message, 1, TIMER_JOB_PERIODIC);
+}
+
+// *************************************************************************************************
+// @fn          sx_battery
+// @brief       Battery direct function. Button DOWN switches between voltage, consumed charge
+//                              and estimated remaining battery life.
+// @param       u8 line         LINE2
+// @return      none
+// *************************************************************************************************
+void sx_battery(u8 line)
+{
+    if (++sBatt.view >= BATTERY_VIEWS)
+        sBatt.view = BATTERY_VIEW_VOLTAGE;
+}
+
 // *************************************************************************************************
 // @fn          display_battery_V
-// @brief       Display routine for battery voltage.
+// @brief       Display routine for battery voltage, consumed charge and remaining battery life.
 // @param       u8 line                 LINE2
-//                              u8 update               DISPLAY_LINE_UPDATE_FULL, DISPLAY_LINE_CLEAR
+//                              u8 update               DISPLAY_LINE_UPDATE_FULL,
+// DISPLAY_LINE_UPDATE_PARTIAL, DISPLAY_LINE_CLEAR
 // @return      none
 // *************************************************************************************************
 void display_battery_V(u8 line, u8 update)
 {
     u8 *str;
+    u16 days;
 
     // Redraw line
-    if (update == DISPLAY_LINE_UPDATE_FULL)
+    if ((update == DISPLAY_LINE_UPDATE_FULL) || (update == DISPLAY_LINE_UPDATE_PARTIAL))
     {
-        // Set battery and V icon
-        display_symbol(LCD_SYMB_BATTERY, SEG_ON);
-
-        // Menu item is visible
-        sBatt.state = MENU_ITEM_VISIBLE;
-
-        // Display result in xx.x format
-        str = int_to_array(sBatt.voltage, 3, 0);
-
-        display_chars(LCD_SEG_L2_2_0, str, SEG_ON);
-        display_symbol(LCD_SEG_L2_DP, SEG_ON);
-    }
-    else if (update == DISPLAY_LINE_UPDATE_PARTIAL)
-    {
-        // Display result in xx.x format
-        str = int_to_array(sBatt.voltage, 3, 0);
-
-        display_chars(LCD_SEG_L2_2_0, str, SEG_ON);
+        if (update == DISPLAY_LINE_UPDATE_FULL)
+        {
+            // Set battery and V icon
+            display_symbol(LCD_SYMB_BATTERY, SEG_ON);
+
+            // Menu item is visible
+            sBatt.state = MENU_ITEM_VISIBLE;
+        }
+
+        switch (sBatt.view)
+        {
+            case BATTERY_VIEW_VOLTAGE:
+                // Display result in x.xx format
+                str = int_to_array(sBatt.voltage, 3, 0);
+                display_chars(LCD_SEG_L2_2_0, str, SEG_ON);
+                display_symbol(LCD_SEG_L2_DP, SEG_ON);
+                break;
+
+            case BATTERY_VIEW_CHARGE:
+                // Display consumed charge in xxx.xx mAh format
+                str = int_to_array(sPower.charge / 10, 5, 2);
+                display_chars(LCD_SEG_L2_4_0, str, SEG_ON);
+                display_symbol(LCD_SEG_L2_DP, SEG_ON);
+                break;
+
+            case BATTERY_VIEW_DAYS:
+                // Display remaining battery life in "d xxxx" format
+                display_char(LCD_SEG_L2_4, 'D', SEG_ON);
+                days = power_get_remaining_days();
+                if (days == 0xFFFF)
+                {
+                    display_chars(LCD_SEG_L2_3_0, (u8 *) "----", SEG_ON);
+                }
+                else
+                {
+                    if (days > 9999)
+                        days = 9999;
+                    display_chars(LCD_SEG_L2_3_0, int_to_array(days, 4, 3), SEG_ON);
+                }
+                break;
+        }
 
         display.flag.update_battery_voltage = 0;
     }
@@ -179,6 +244,7 @@ void display_battery_V(u8 line, u8 update)
 
         // Clear function-specific symbols
         display_symbol(LCD_SYMB_BATTERY, SEG_OFF);
+        display_symbol(LCD_SEG_L2_DP, SEG_OFF);
     }
 }
 
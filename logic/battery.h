@@ -45,8 +45,10 @@
 // Internal functions
 extern void reset_batt_measurement(void);
 extern void battery_measurement(void);
+extern void tick_battery(void);
 
 // Menu functions
+extern void sx_battery(u8 line);
 extern void display_battery_V(u8 line, u8 update);
 
 // *************************************************************************************************
@@ -61,12 +63,18 @@ extern void display_battery_V(u8 line, u8 update);
 // Show "lobatt" message every n seconds
 #define BATTERY_LOW_MESSAGE_CYCLE               (15u)
 
+// Battery views (Line2)
+#define BATTERY_VIEW_VOLTAGE                    (0u)
+#define BATTERY_VIEW_CHARGE                     (1u)
+#define BATTERY_VIEW_DAYS                       (2u)
+#define BATTERY_VIEWS                           (3u)
+
 // *************************************************************************************************
 // Global Variable section
 struct batt
 {
     menu_t state;               // MENU_ITEM_NOT_VISIBLE, MENU_ITEM_VISIBLE
-    u8 lobatt_display;          // Counter for alternating "lobatt" display
+    u8 view;                    // BATTERY_VIEW_xxx
     u16 voltage;                // Battery voltage
     s16 offset;                 // Battery voltage offset
 };
@@ -45,6 +45,8 @@
 #include "ports.h"
 #include "display.h"
 #include "timer.h"
+#include "rtc.h"
+#include "task.h"
 
 // logic
 #include "menu.h"
@@ -57,6 +59,7 @@
 void reset_clock(void);
 void clock_tick(void);
 void mx_time(u8 line);
+PT_THREAD(mx_time_flow(struct pt *pt));
 void sx_time(u8 line);
 
 void calc_24H_to_12H(u8 * hours, u8 * timeAM);
@@ -94,6 +97,7 @@ void reset_clock(void)
     sTime.hour = 4;
     sTime.minute = 30;
     sTime.second = 0;
+    rtc_set_time(sTime.hour, sTime.minute, sTime.second);
 
     // Display style of both lines is default (HH:MM)
     sTime.line1ViewStyle = DISPLAY_DEFAULT_VIEW;
@@ -104,46 +108,47 @@ void reset_clock(void)
 
 // *************************************************************************************************
 // @fn          clock_tick
-// @brief       Add 1 second to system time and to display time
+// @brief       Copy RTC time to system time and to display time. Called every second, or once a
+//                              minute in minute tick mode.
 // @param       none
 // @return      none
 // *************************************************************************************************
 void clock_tick(void)
 {
+    u8 hour, minute, second;
+    s16 elapsed;
+
+    rtc_get_time(&hour, &minute, &second);
+
     // Use sTime.drawFlag to minimize display updates
     // sTime.drawFlag = 1: second
     // sTime.drawFlag = 2: minute, second
     // sTime.drawFlag = 3: hour, minute
-    sTime.drawFlag = 1;
-
-    // Increase global system time
-    sTime.system_time++;
+    if (hour != sTime.hour)
+        sTime.drawFlag = 3;
+    else if (minute != sTime.minute)
+        sTime.drawFlag = 2;
+    else
+        sTime.drawFlag = 1;
 
-    // Add 1 second
-    sTime.second++;
+    // Increase global system time - clock tick is at least once per minute
+    elapsed = (s16) (minute * 60 + second) - (s16) (sTime.minute * 60 + sTime.second);
+    if (elapsed < 0)
+        elapsed += 3600;
+    sTime.system_time += elapsed;
 
-    // Add 1 minute
-    if (sTime.second == 60)
+    // New day - RTC has also updated date
+    if (hour < sTime.hour)
     {
-        sTime.second = 0;
-        sTime.minute++;
-        sTime.drawFlag++;
+        rtc_get_date(&sDate.year, &sDate.month, &sDate.day);
 
-        // Add 1 hour
-        if (sTime.minute == 60)
-        {
-            sTime.minute = 0;
-            sTime.hour++;
-            sTime.drawFlag++;
-
-            // Add 1 day
-            if (sTime.hour == 24)
-            {
-                sTime.hour = 0;
-                add_day();
-            }
-        }
+        // Indicate to display function that new value is available
+        display.flag.full_update = 1;
     }
+
+    sTime.hour = hour;
+    sTime.minute = minute;
+    sTime.second = second;
 }
 
 // *************************************************************************************************
@@ -197,20 +202,33 @@ void display_selection_Timeformat1(u8 segments, u32 index, u8 digits, u8 blanks)
 
 // *************************************************************************************************
 // @fn          mx_time
-// @brief       Clock set routine.
+// @brief       Clock set routine. Runs as foreground flow mx_time_flow().
 // @param       u8 line         LINE1, LINE2
 // @return      none
 // *************************************************************************************************
 void mx_time(u8 line)
 {
-    u8 select;
-    s32 timeformat;
-    s16 timeformat1;
-    s32 hours;
-    s32 minutes;
-    s32 seconds;
+    task_flow_start(mx_time_flow);
+}
+
+// *************************************************************************************************
+// @fn          mx_time_flow
+// @brief       Clock set flow.
+// @param       struct pt *pt   Protothread state
+// @return      u8              PT_WAITING, PT_ENDED
+// *************************************************************************************************
+PT_THREAD(mx_time_flow(struct pt *pt))
+{
+    static u8 select;
+    static s32 timeformat;
+    static s16 timeformat1;
+    static s32 hours;
+    static s32 minutes;
+    static s32 seconds;
     u8 *str;
 
+    PT_BEGIN(pt);
+
     // Clear display
     clear_display_all();
 
@@ -250,79 +268,80 @@ void mx_time(u8 line)
         // Button STAR (short): save, then exit
         if (button.flag.star)
         {
-            // Stop clock timer
-            Timer0_Stop();
-
             // Store local variables in global clock time
             sTime.hour = hours;
             sTime.minute = minutes;
             sTime.second = seconds;
-
-            // Start clock timer
-            Timer0_Start();
+            rtc_set_time(sTime.hour, sTime.minute, sTime.second);
 
             // Full display update is done when returning from function
             display_symbol(LCD_SYMB_AM, SEG_OFF);
             break;
         }
 
-        switch (select)
+        // No switch statement - set_value() waits
+        if (select == 0)
+        {
+            // Clear LINE1 and LINE2 and AM icon - required when coming back from
+            // set_value(seconds)
+            clear_display();
+            display_symbol(LCD_SYMB_AM, SEG_OFF);
+
+            // Set 24H / 12H time format
+            PT_SPAWN(pt, &sSetValue.pt, set_value(
+                &sSetValue.pt, &timeformat, 1, 0, 0, 1, SETVALUE_ROLLOVER_VALUE +
+                SETVALUE_DISPLAY_SELECTION + SETVALUE_NEXT_VALUE, LCD_SEG_L1_3_1,
+                display_selection_Timeformat1));
+
+            // Modify global time format variable immediately to update AM/PM icon correctly
+            if (timeformat == TIMEFORMAT_24H)
+                sys.flag.use_metric_units = 1;
+            else
+                sys.flag.use_metric_units = 0;
+            select = 1;
+        }
+        else if (select == 1)
+        {
+            // Display HH:MM (LINE1) and .SS (LINE2)
+            str = int_to_array(hours, 2, 0);
+            display_chars(LCD_SEG_L1_3_2, str, SEG_ON);
+            display_symbol(LCD_SEG_L1_COL, SEG_ON);
+
+            str = int_to_array(minutes, 2, 0);
+            display_chars(LCD_SEG_L1_1_0, str, SEG_ON);
+
+            str = int_to_array(seconds, 2, 0);
+            display_chars(LCD_SEG_L2_1_0, str, SEG_ON);
+            display_symbol(LCD_SEG_L2_DP, SEG_ON);
+
+            // Set hours
+            PT_SPAWN(pt, &sSetValue.pt, set_value(
+                &sSetValue.pt, &hours, 2, 0, 0, 23, SETVALUE_ROLLOVER_VALUE +
+                SETVALUE_DISPLAY_VALUE + SETVALUE_NEXT_VALUE, LCD_SEG_L1_3_2, display_hours));
+            select = 2;
+        }
+        else if (select == 2)
         {
-            case 0:            // Clear LINE1 and LINE2 and AM icon - required when coming back from
-                               // set_value(seconds)
-                clear_display();
-                display_symbol(LCD_SYMB_AM, SEG_OFF);
-
-                // Set 24H / 12H time format
-                set_value(
-                    &timeformat, 1, 0, 0, 1, SETVALUE_ROLLOVER_VALUE + SETVALUE_DISPLAY_SELECTION +
-                    SETVALUE_NEXT_VALUE, LCD_SEG_L1_3_1, display_selection_Timeformat1);
-
-                // Modify global time format variable immediately to update AM/PM icon correctly
-                if (timeformat == TIMEFORMAT_24H)
-                    sys.flag.use_metric_units = 1;
-                else
-                    sys.flag.use_metric_units = 0;
-                select = 1;
-                break;
-
-            case 1:            // Display HH:MM (LINE1) and .SS (LINE2)
-                str = int_to_array(hours, 2, 0);
-                display_chars(LCD_SEG_L1_3_2, str, SEG_ON);
-                display_symbol(LCD_SEG_L1_COL, SEG_ON);
-
-                str = int_to_array(minutes, 2, 0);
-                display_chars(LCD_SEG_L1_1_0, str, SEG_ON);
-
-                str = int_to_array(seconds, 2, 0);
-                display_chars(LCD_SEG_L2_1_0, str, SEG_ON);
-                display_symbol(LCD_SEG_L2_DP, SEG_ON);
-
-                // Set hours
-                set_value(&hours, 2, 0, 0, 23, SETVALUE_ROLLOVER_VALUE + SETVALUE_DISPLAY_VALUE +
-                          SETVALUE_NEXT_VALUE, LCD_SEG_L1_3_2,
-                          display_hours);
-                select = 2;
-                break;
-
-            case 2:            // Set minutes
-                set_value(&minutes, 2, 0, 0, 59, SETVALUE_ROLLOVER_VALUE + SETVALUE_DISPLAY_VALUE +
-                          SETVALUE_NEXT_VALUE, LCD_SEG_L1_1_0,
-                          display_value);
-                select = 3;
-                break;
-
-            case 3:            // Set seconds
-                set_value(&seconds, 2, 0, 0, 59, SETVALUE_ROLLOVER_VALUE + SETVALUE_DISPLAY_VALUE +
-                          SETVALUE_NEXT_VALUE, LCD_SEG_L2_1_0,
-                          display_value);
-                select = 0;
-                break;
+            // Set minutes
+            PT_SPAWN(pt, &sSetValue.pt, set_value(
+                &sSetValue.pt, &minutes, 2, 0, 0, 59, SETVALUE_ROLLOVER_VALUE +
+                SETVALUE_DISPLAY_VALUE + SETVALUE_NEXT_VALUE, LCD_SEG_L1_1_0, display_value));
+            select = 3;
+        }
+        else
+        {
+            // Set seconds
+            PT_SPAWN(pt, &sSetValue.pt, set_value(
+                &sSetValue.pt, &seconds, 2, 0, 0, 59, SETVALUE_ROLLOVER_VALUE +
+                SETVALUE_DISPLAY_VALUE + SETVALUE_NEXT_VALUE, LCD_SEG_L2_1_0, display_value));
+            select = 0;
         }
     }
 
     // Clear button flags
     button.all_flags = 0;
+
+    PT_END(pt);
 }
 
 // *************************************************************************************************
@@ -8,6 +8,7 @@
 #include "as.h"
 #include "adc12.h"
 #include "timer.h"
+#include "event.h"
 
 // logic
 #include "user.h"
@@ -59,6 +60,7 @@ void display_counter(u8 line, u8 update)
 
 		// Menu item is visible
 		sCounter.state = MENU_ITEM_VISIBLE;
+		timer_job_start(TIMER_JOB_COUNTER, tick_counter, 1, TIMER_JOB_PERIODIC);
 
 		case DISPLAY_LINE_UPDATE_PARTIAL:
 			if(sCounter.style == 0){
@@ -106,6 +108,7 @@ void display_counter(u8 line, u8 update)
 
 			// Menu item is not visible
 			sCounter.state = MENU_ITEM_NOT_VISIBLE;
+			timer_job_stop(TIMER_JOB_COUNTER);
 		break;
 	}
 }
@@ -115,6 +118,13 @@ u8 is_counter_measurement(void)
 	return sCounter.state == MENU_ITEM_VISIBLE;
 }
 
+// Timer job while counter is visible: in case a DRDY IRQ was missed, get data now
+void tick_counter(void)
+{
+	if ((AS_INT_IN & AS_INT_PIN) == AS_INT_PIN)
+		event_post(EVENT_COUNTER_MEASUREMENT, 0);
+}
+
 #define WALK_COUNT_THRESHOLD  200
 #define RUN_COUNT_THRESHOLD  150
 void do_count(void)
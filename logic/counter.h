@@ -17,6 +17,7 @@ extern void sx_counter(u8 line);
 extern void display_counter(u8 line, u8 update);
 extern u8 is_counter_measurement(void);
 extern void do_counter_measurement(void);
+extern void tick_counter(void);
 
 
 // *************************************************************************************************
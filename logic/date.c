@@ -44,6 +44,8 @@
 // driver
 #include "display.h"
 #include "ports.h"
+#include "rtc.h"
+#include "task.h"
 
 // logic
 #include "date.h"
@@ -53,8 +55,8 @@
 // Prototypes section
 void reset_date(void);
 u8 get_numberOfDays(u8 month, u16 year);
-void add_day(void);
 void mx_date(u8 line);
+PT_THREAD(mx_date_flow(struct pt *pt));
 void sx_date(u8 line);
 void display_date(u8 line, u8 update);
 
@@ -82,6 +84,7 @@ void reset_date(void)
     sDate.year = 2009;
     sDate.month = 8;
     sDate.day = 1;
+    rtc_set_date(sDate.year, sDate.month, sDate.day);
 
     // Show day and month on display
     sDate.display = DISPLAY_DEFAULT_VIEW;
@@ -130,53 +133,34 @@ u8 get_numberOfDays(u8 month, u16 year)
 }
 
 // *************************************************************************************************
-// @fn          add_day
-// @brief       Add one day to current date. Called when clock changes from 23:59 to 00:00
-// @param       none
+// @fn          mx_date
+// @brief       Date set routine. Runs as foreground flow mx_date_flow().
+// @param       line            LINE1, LINE2
 // @return      none
 // *************************************************************************************************
-void add_day(void)
+void mx_date(u8 line)
 {
-    // Add 1 day
-    sDate.day++;
-
-    // Check if day overflows into next month
-    if (sDate.day > get_numberOfDays(sDate.month, sDate.year))
-    {
-        // Add 1 month and reset to day to 1
-        sDate.day = 1;
-        sDate.month++;
-
-        // Check if month overflows into next year
-        if (sDate.month > 12)
-        {
-            // Add 1 year and reset month and day to 1
-            sDate.day = 1;
-            sDate.month = 1;
-            sDate.year++;
-        }
-    }
-
-    // Indicate to display function that new value is available
-    display.flag.full_update = 1;
+    task_flow_start(mx_date_flow);
 }
 
 // *************************************************************************************************
-// @fn          mx_date
-// @brief       Date set routine.
-// @param       line            LINE1, LINE2
-// @return      none
+// @fn          mx_date_flow
+// @brief       Date set flow.
+// @param       struct pt *pt   Protothread state
+// @return      u8              PT_WAITING, PT_ENDED
 // *************************************************************************************************
-void mx_date(u8 line)
+PT_THREAD(mx_date_flow(struct pt *pt))
 {
-    u8 select;
-    s32 day;
-    s32 month;
-    s32 year;
-    s16 max_days;
+    static u8 select;
+    static s32 day;
+    static s32 month;
+    static s32 year;
+    static s16 max_days;
     u8 *str;
     u8 *str1;
 
+    PT_BEGIN(pt);
+
     // Clear display
     clear_display_all();
 
@@ -184,6 +168,7 @@ void mx_date(u8 line)
     day = sDate.day;
     month = sDate.month;
     year = sDate.year;
+    max_days = get_numberOfDays(month, year);
 
     // Init value index
     select = 0;
@@ -224,49 +209,54 @@ void mx_date(u8 line)
             sDate.day = day;
             sDate.month = month;
             sDate.year = year;
+            rtc_set_date(sDate.year, sDate.month, sDate.day);
 
             // Full display update is done when returning from function
             break;
         }
 
-        switch (select)
+        // No switch statement - set_value() waits
+        if (select == 0)
         {
-            case 0:            // Set year
-                set_value(&year, 4, 0, 2008, 2100, SETVALUE_DISPLAY_VALUE + SETVALUE_NEXT_VALUE,
-                          LCD_SEG_L2_3_0,
-                          display_value);
-                select = 1;
-                break;
-            case 1:            // Set month
-                if (sys.flag.use_metric_units)
-                {
-                    set_value(
-                        &month, 2, 0, 1, 12, SETVALUE_ROLLOVER_VALUE + SETVALUE_DISPLAY_VALUE +
-                        SETVALUE_NEXT_VALUE, LCD_SEG_L1_1_0, display_value);
-                }
-                else           // English units
-                {
-                    set_value(
-                        &month, 2, 0, 1, 12, SETVALUE_ROLLOVER_VALUE + SETVALUE_DISPLAY_VALUE +
-                        SETVALUE_NEXT_VALUE, LCD_SEG_L1_3_2, display_value);
-                }
-                select = 2;
-                break;
-            case 2:            // Set day
-                if (sys.flag.use_metric_units)
-                {
-                    set_value(
-                        &day, 2, 0, 1, max_days, SETVALUE_ROLLOVER_VALUE + SETVALUE_DISPLAY_VALUE +
-                        SETVALUE_NEXT_VALUE, LCD_SEG_L1_3_2, display_value);
-                }
-                else           // English units
-                {
-                    set_value(
-                        &day, 2, 0, 1, max_days, SETVALUE_ROLLOVER_VALUE + SETVALUE_DISPLAY_VALUE +
-                        SETVALUE_NEXT_VALUE, LCD_SEG_L1_1_0, display_value);
-                }
-                select = 0;
-                break;
+            // Set year
+            PT_SPAWN(pt, &sSetValue.pt, set_value(
+                &sSetValue.pt, &year, 4, 0, 2008, 2100, SETVALUE_DISPLAY_VALUE +
+                SETVALUE_NEXT_VALUE, LCD_SEG_L2_3_0, display_value));
+            select = 1;
+        }
+        else if (select == 1)
+        {
+            // Set month
+            if (sys.flag.use_metric_units)
+            {
+                PT_SPAWN(pt, &sSetValue.pt, set_value(
+                    &sSetValue.pt, &month, 2, 0, 1, 12, SETVALUE_ROLLOVER_VALUE +
+                    SETVALUE_DISPLAY_VALUE + SETVALUE_NEXT_VALUE, LCD_SEG_L1_1_0, display_value));
+            }
+            else       // English units
+            {
+                PT_SPAWN(pt, &sSetValue.pt, set_value(
+                    &sSetValue.pt, &month, 2, 0, 1, 12, SETVALUE_ROLLOVER_VALUE +
+                    SETVALUE_DISPLAY_VALUE + SETVALUE_NEXT_VALUE, LCD_SEG_L1_3_2, display_value));
+            }
+            select = 2;
+        }
+        else
+        {
+            // Set day
+            if (sys.flag.use_metric_units)
+            {
+                PT_SPAWN(pt, &sSetValue.pt, set_value(
+                    &sSetValue.pt, &day, 2, 0, 1, max_days, SETVALUE_ROLLOVER_VALUE +
+                    SETVALUE_DISPLAY_VALUE + SETVALUE_NEXT_VALUE, LCD_SEG_L1_3_2, display_value));
+            }
+            else       // English units
+            {
+                PT_SPAWN(pt, &sSetValue.pt, set_value(
+                    &sSetValue.pt, &day, 2, 0, 1, max_days, SETVALUE_ROLLOVER_VALUE +
+                    SETVALUE_DISPLAY_VALUE + SETVALUE_NEXT_VALUE, LCD_SEG_L1_1_0, display_value));
+            }
+            select = 0;
         }
 
         // Check if day is still valid, if not clamp to last day of current month
@@ -277,6 +267,8 @@ void mx_date(u8 line)
 
     // Clear button flag
     button.all_flags = 0;
+
+    PT_END(pt);
 }
 
 // *************************************************************************************************
@@ -42,7 +42,6 @@
 // *************************************************************************************************
 // Prototypes section
 extern void reset_date(void);
-extern void add_day(void);
 extern void mx_date(u8 line);
 extern void sx_date(u8 line);
 extern void display_date(u8 line, u8 update);
@@ -0,0 +1,231 @@
+// *************************************************************************************************
+// Delta encoder and decoder for sensor samples. Consecutive samples differ very little, so
+// differences mostly fit in one nibble instead of one byte per value. The decoder has no target
+// dependencies, so access point or host software can build it as is.
+// *************************************************************************************************
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// logic
+#include "delta.h"
+
+// *************************************************************************************************
+// Prototypes section
+void delta_start(struct delta *d, u8 * buf, u8 size, u8 channels, const u8 * values);
+u8 delta_put(struct delta *d, const u8 * values);
+u8 delta_length(const struct delta *d);
+void delta_open(struct delta *d, u8 * buf, u8 size, u8 channels, u8 * values);
+u8 delta_get(struct delta *d, u8 * values);
+static void delta_put_nibble(struct delta *d, u8 nibble);
+static u8 delta_get_nibble(struct delta *d);
+
+// *************************************************************************************************
+// Defines section
+
+// *************************************************************************************************
+// Global Variable section
+
+// *************************************************************************************************
+// Extern section
+
+// *************************************************************************************************
+// @fn          delta_start
+// @brief       Start new block with raw keyframe sample. Buffer must hold at least one sample.
+// @param       struct delta *d         Encoder state
+//                              u8 * buf                Output buffer
+//                              u8 size                 Output buffer size (bytes)
+//                              u8 channels             Values per sample (1..DELTA_CHANNELS_MAX)
+//                              const u8 * values       First sample
+// @return      none
+// *************************************************************************************************
+void delta_start(struct delta *d, u8 * buf, u8 size, u8 channels, const u8 * values)
+{
+    u8 i;
+
+    d->buf = buf;
+    d->size = size;
+    d->channels = channels;
+
+    for (i = 0; i < channels; i++)
+    {
+        buf[i] = values[i];
+        d->last[i] = values[i];
+    }
+    d->pos = channels * 2;
+}
+
+// *************************************************************************************************
+// @fn          delta_put
+// @brief       Append sample as differences to previous sample. Nothing is written when the
+//                              coded sample does not fit into the buffer.
+// @param       struct delta *d         Encoder state
+//                              const u8 * values       Sample
+// @return      u8                      1 = Sample added, 0 = Buffer full
+// *************************************************************************************************
+u8 delta_put(struct delta *d, const u8 * values)
+{
+    u8 zz[DELTA_CHANNELS_MAX];
+    u8 nibbles = 0;
+    u8 i;
+    s8 diff;
+
+    // Zig-zag code differences: 0, -1, 1, -2, 2, ... -> 0, 1, 2, 3, 4, ...
+    for (i = 0; i < d->channels; i++)
+    {
+        diff = (s8) (values[i] - d->last[i]);
+        zz[i] = ((u8) diff << 1) ^ (u8) (diff >> 7);
+        nibbles += (zz[i] < DELTA_ESCAPE) ? 1 : 3;
+    }
+
+    if (d->pos + nibbles > d->size * 2)
+        return (0);
+
+    for (i = 0; i < d->channels; i++)
+    {
+        if (zz[i] < DELTA_ESCAPE)
+        {
+            delta_put_nibble(d, zz[i]);
+        }
+        else
+        {
+            delta_put_nibble(d, DELTA_ESCAPE);
+            delta_put_nibble(d, zz[i] >> 4);
+            delta_put_nibble(d, zz[i] & 0x0F);
+        }
+        d->last[i] = values[i];
+    }
+
+    return (1);
+}
+
+// *************************************************************************************************
+// @fn          delta_length
+// @brief       Bytes used by block. An unused low nibble in the last byte is 0, so the number
+//                              of samples must be stored with the block.
+// @param       const struct delta *d   Encoder state
+// @return      u8                      Block length (bytes)
+// *************************************************************************************************
+u8 delta_length(const struct delta *d)
+{
+    return ((d->pos + 1) / 2);
+}
+
+// *************************************************************************************************
+// @fn          delta_put_nibble
+// @brief       Write one nibble, high nibble of each byte first.
+// @param       struct delta *d         Encoder state
+//                              u8 nibble               Nibble (0..15)
+// @return      none
+// *************************************************************************************************
+static void delta_put_nibble(struct delta *d, u8 nibble)
+{
+    if (d->pos & 1)
+    {
+        d->buf[d->pos / 2] |= nibble;
+    }
+    else
+    {
+        d->buf[d->pos / 2] = nibble << 4;
+    }
+    d->pos++;
+}
+
+// *************************************************************************************************
+// @fn          delta_open
+// @brief       Open block for decoding and read raw keyframe sample. Buffer must hold at least
+//                              one sample.
+// @param       struct delta *d         Decoder state
+//                              u8 *buf                 Block
+//                              u8 size                 Block length (bytes)
+//                              u8 channels             Values per sample (1..DELTA_CHANNELS_MAX)
+//                              u8 *values              First sample
+// @return      none
+// *************************************************************************************************
+void delta_open(struct delta *d, u8 * buf, u8 size, u8 channels, u8 * values)
+{
+    u8 i;
+
+    d->buf = buf;
+    d->size = size;
+    d->channels = channels;
+
+    for (i = 0; i < channels; i++)
+    {
+        values[i] = buf[i];
+        d->last[i] = buf[i];
+    }
+    d->pos = channels * 2;
+}
+
+// *************************************************************************************************
+// @fn          delta_get
+// @brief       Read next sample. The block does not store a sample count - the caller reads as
+//                              many samples as were put, an unused low nibble at the end is
+//                              padding.
+// @param       struct delta *d         Decoder state
+//                              u8 *values              Next sample
+// @return      u8                      1 = Sample read, 0 = End of block
+// *************************************************************************************************
+u8 delta_get(struct delta *d, u8 * values)
+{
+    u8 zz[DELTA_CHANNELS_MAX];
+    u8 pos = d->pos;
+    u8 i;
+
+    // Check that the whole sample is in the block before changing the state
+    for (i = 0; i < d->channels; i++)
+    {
+        if (d->pos >= d->size * 2)
+        {
+            d->pos = pos;
+            return (0);
+        }
+        zz[i] = delta_get_nibble(d);
+        if (zz[i] == DELTA_ESCAPE)
+        {
+            if (d->pos + 2 > d->size * 2)
+            {
+                d->pos = pos;
+                return (0);
+            }
+            zz[i] = delta_get_nibble(d) << 4;
+            zz[i] |= delta_get_nibble(d);
+        }
+    }
+
+    // Undo zig-zag code: 0, 1, 2, 3, 4, ... -> 0, -1, 1, -2, 2, ...
+    for (i = 0; i < d->channels; i++)
+    {
+        d->last[i] += (zz[i] >> 1) ^ (u8) (0 - (zz[i] & 1));
+        values[i] = d->last[i];
+    }
+
+    return (1);
+}
+
+// *************************************************************************************************
+// @fn          delta_get_nibble
+// @brief       Read one nibble, high nibble of each byte first.
+// @param       struct delta *d         Decoder state
+// @return      u8                      Nibble
+// *************************************************************************************************
+static u8 delta_get_nibble(struct delta *d)
+{
+    u8 nibble;
+
+    if (d->pos & 1)
+    {
+        nibble = d->buf[d->pos / 2] & 0x0F;
+    }
+    else
+    {
+        nibble = d->buf[d->pos / 2] >> 4;
+    }
+    d->pos++;
+
+    return (nibble);
+}
@@ -0,0 +1,54 @@
+// *************************************************************************************************
+// Delta encoder and decoder for sensor samples.
+// *************************************************************************************************
+
+#ifndef DELTA_H_
+#define DELTA_H_
+
+// *************************************************************************************************
+// Include section
+
+// *************************************************************************************************
+// Prototypes section
+struct delta;
+extern void delta_start(struct delta *d, u8 * buf, u8 size, u8 channels, const u8 * values);
+extern u8 delta_put(struct delta *d, const u8 * values);
+extern u8 delta_length(const struct delta *d);
+extern void delta_open(struct delta *d, u8 * buf, u8 size, u8 channels, u8 * values);
+extern u8 delta_get(struct delta *d, u8 * values);
+
+// *************************************************************************************************
+// Defines section
+
+// Maximum number of values per sample
+#define DELTA_CHANNELS_MAX              (3u)
+
+// Nibble that announces a full byte (zig-zag value 15..255)
+#define DELTA_ESCAPE                    (0x0Fu)
+
+// *************************************************************************************************
+// Global Variable section
+
+// Encoder / decoder state. A block starts with a raw keyframe sample, every further value is
+// stored as zig-zag coded difference to the previous sample: 0..14 in one nibble, else escape
+// nibble and a full byte. Nibbles are written high nibble first.
+struct delta
+{
+    // Block buffer and its size (bytes)
+    u8 *buf;
+    u8 size;
+
+    // Write / read position (nibbles)
+    u8 pos;
+
+    // Values per sample
+    u8 channels;
+
+    // Previous sample
+    u8 last[DELTA_CHANNELS_MAX];
+};
+
+// *************************************************************************************************
+// Extern section
+
+#endif                          /*DELTA_H_ */
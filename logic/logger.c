@@ -0,0 +1,267 @@
+// *************************************************************************************************
+// Data logger. Records steps, altitude, temperature and battery voltage in main flash every
+// LOGGER_INTERVAL minutes. Flash is written so that a power loss at any time leaves only
+// complete pages and records valid: page header marker and record hour are written last, and
+// a page is erased only right before it is reused.
+// *************************************************************************************************
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// driver
+#include "flash.h"
+#include "event.h"
+#include "ps.h"
+
+// logic
+#include "logger.h"
+#include "clock.h"
+#include "date.h"
+#include "altitude.h"
+#include "temperature.h"
+#include "battery.h"
+#include "counter.h"
+
+// *************************************************************************************************
+// Prototypes section
+void reset_logger(void);
+void logger_tick(u8 param);
+void logger_rebase(void);
+void logger_erase(void);
+void logger_get_block(u16 block, u8 * data);
+static struct logger_page *logger_page(u8 page);
+static struct logger_record *logger_record(u8 page, u8 record);
+static u8 logger_is_erased(const u8 * ptr, u16 length);
+static void logger_invalidate(u8 page);
+static void logger_open(void);
+
+// *************************************************************************************************
+// Defines section
+
+// *************************************************************************************************
+// Global Variable section
+struct logger sLogger;
+
+// *************************************************************************************************
+// Extern section
+
+// *************************************************************************************************
+// @fn          reset_logger
+// @brief       Find newest valid page and first free record in it.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void reset_logger(void)
+{
+    struct logger_page *header;
+    u8 page;
+    u8 record;
+
+    sLogger.page = LOGGER_PAGES;
+    sLogger.record = 0;
+    sLogger.seq = 0;
+
+    for (page = 0; page < LOGGER_PAGES; page++)
+    {
+        header = logger_page(page);
+        if ((header->magic == LOGGER_MAGIC) &&
+            ((sLogger.page == LOGGER_PAGES) || (header->seq > sLogger.seq)))
+        {
+            sLogger.page = page;
+            sLogger.seq = header->seq;
+        }
+    }
+
+    if (sLogger.page == LOGGER_PAGES)
+        return;
+
+    // Continue after last record that was (partially) written
+    for (record = LOGGER_RECORDS; record > 0; record--)
+    {
+        if (!logger_is_erased((u8 *) logger_record(sLogger.page, record - 1),
+                              sizeof(struct logger_record)))
+            break;
+    }
+    sLogger.record = record;
+}
+
+// *************************************************************************************************
+// @fn          logger_tick
+// @brief       Measure and write one record. Opens next page when needed. Called every
+//                              LOGGER_INTERVAL minutes by the request task, which only runs from
+//                              idle_loop() - never inside a driver that waits in
+//                              Timer0_A4_Delay(), so measuring here does not nest conversions.
+//                              Without a running altitude measurement a single conversion is
+//                              started first; the record is written when it posts EVENT_LOGGER
+//                              again with ALTITUDE_CONVERSION_DONE.
+// @param       u8 param        0 = record is due, ALTITUDE_CONVERSION_DONE = altitude is updated
+// @return      none
+// *************************************************************************************************
+void logger_tick(u8 param)
+{
+    struct logger_record rec;
+
+    // Get updated altitude - reuse altitude of running Line1 measurement
+    if ((param != ALTITUDE_CONVERSION_DONE) && start_altitude_conversion(EVENT_LOGGER))
+        return;
+
+    if ((sLogger.page == LOGGER_PAGES) || (sLogger.record >= LOGGER_RECORDS))
+        logger_open();
+
+    // Get updated temperature
+    temperature_measurement(FILTER_OFF);
+
+    rec.steps = sCounter.count;
+    rec.altitude = sAlt.altitude;
+    rec.temperature = sTemp.degrees;
+    rec.voltage = sBatt.voltage;
+    rec.minute = sTime.minute;
+    rec.hour = sTime.hour;
+
+    flash_write((u8 *) logger_record(sLogger.page, sLogger.record), (const u8 *) &rec,
+                sizeof(rec));
+    sLogger.record++;
+}
+
+// *************************************************************************************************
+// @fn          logger_rebase
+// @brief       Clock was set. Next record opens a new page, so that page dates stay correct.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void logger_rebase(void)
+{
+    sLogger.record = LOGGER_RECORDS;
+}
+
+// *************************************************************************************************
+// @fn          logger_erase
+// @brief       Clear log. Pages are only marked invalid here, they are erased before reuse.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void logger_erase(void)
+{
+    u8 page;
+
+    for (page = 0; page < LOGGER_PAGES; page++)
+    {
+        logger_invalidate(page);
+    }
+    sLogger.page = LOGGER_PAGES;
+}
+
+// *************************************************************************************************
+// @fn          logger_get_block
+// @brief       Copy block of log memory. Blocks outside log memory read as erased flash.
+// @param       u16 block               Block index
+//                              u8 * data               Destination, LOGGER_BLOCK_SIZE bytes
+// @return      none
+// *************************************************************************************************
+void logger_get_block(u16 block, u8 * data)
+{
+    const u8 *ptr = LOGGER_START + block * LOGGER_BLOCK_SIZE;
+    u8 i;
+
+    for (i = 0; i < LOGGER_BLOCK_SIZE; i++)
+    {
+        data[i] = (block < LOGGER_BLOCKS) ? ptr[i] : FLASH_ERASED;
+    }
+}
+
+// *************************************************************************************************
+// @fn          logger_page
+// @brief       Get page header.
+// @param       u8 page                 Page index
+// @return      struct logger_page *    Page header in flash
+// *************************************************************************************************
+static struct logger_page *logger_page(u8 page)
+{
+    return ((struct logger_page *) (LOGGER_START + page * LOGGER_PAGE_SIZE));
+}
+
+// *************************************************************************************************
+// @fn          logger_record
+// @brief       Get record slot.
+// @param       u8 page                 Page index
+//                              u8 record               Record index
+// @return      struct logger_record *  Record in flash
+// *************************************************************************************************
+static struct logger_record *logger_record(u8 page, u8 record)
+{
+    return ((struct logger_record *) (LOGGER_START + page * LOGGER_PAGE_SIZE +
+                                      sizeof(struct logger_page)) + record);
+}
+
+// *************************************************************************************************
+// @fn          logger_is_erased
+// @brief       Check if flash area was not written since last erase.
+// @param       const u8 * ptr          Flash area
+//                              u16 length              Length (bytes)
+// @return      u8                      1 = All bytes erased
+// *************************************************************************************************
+static u8 logger_is_erased(const u8 * ptr, u16 length)
+{
+    while (length--)
+    {
+        if (*ptr++ != FLASH_ERASED)
+            return (0);
+    }
+    return (1);
+}
+
+// *************************************************************************************************
+// @fn          logger_invalidate
+// @brief       Mark page invalid by clearing its header marker. Flash bits can be cleared
+//                              without erase.
+// @param       u8 page                 Page index
+// @return      none
+// *************************************************************************************************
+static void logger_invalidate(u8 page)
+{
+    u16 zero = 0;
+
+    if (logger_page(page)->magic == LOGGER_MAGIC)
+        flash_write((u8 *) & logger_page(page)->magic, (const u8 *) &zero, sizeof(zero));
+}
+
+// *************************************************************************************************
+// @fn          logger_open
+// @brief       Erase next page (oldest when log is full) and write its header.
+// @param       none
+// @return      none
+// *************************************************************************************************
+static void logger_open(void)
+{
+    struct logger_page header;
+    u8 i;
+
+    // Log empty starts at first page, sequence numbers keep counting up
+    if (sLogger.page < LOGGER_PAGES)
+        sLogger.page = (sLogger.page + 1) % LOGGER_PAGES;
+    else
+        sLogger.page = 0;
+    sLogger.seq++;
+
+    // Invalidate before erase, so that an interrupted erase never leaves a valid header
+    logger_invalidate(sLogger.page);
+    flash_erase((u8 *) logger_page(sLogger.page));
+
+    header.seq = sLogger.seq;
+    header.year = sDate.year;
+    header.month = sDate.month;
+    header.day = sDate.day;
+    header.hour = sTime.hour;
+    header.minute = sTime.minute;
+    for (i = 0; i < sizeof(header.reserved); i++)
+    {
+        header.reserved[i] = FLASH_ERASED;
+    }
+    header.magic = LOGGER_MAGIC;
+
+    flash_write((u8 *) logger_page(sLogger.page), (const u8 *) &header, sizeof(header));
+    sLogger.record = 0;
+}
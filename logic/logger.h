@@ -0,0 +1,102 @@
+// *************************************************************************************************
+// Data logger interface and flash layout of log memory.
+// *************************************************************************************************
+
+#ifndef LOGGER_H_
+#define LOGGER_H_
+
+// *************************************************************************************************
+// Include section
+
+// *************************************************************************************************
+// Prototypes section
+extern void reset_logger(void);
+extern void logger_tick(u8 param);
+extern void logger_rebase(void);
+extern void logger_erase(void);
+extern void logger_get_block(u16 block, u8 * data);
+
+// *************************************************************************************************
+// Defines section
+
+// Log memory in main flash, reserved in linker command file. One page per flash segment.
+#define LOGGER_START                    ((u8 *) 0x8000)
+#define LOGGER_PAGES                    (4u)
+#define LOGGER_PAGE_SIZE                (512u)
+
+// Log memory is downloaded in blocks of 16 bytes (SYNC memory packets)
+#define LOGGER_BLOCK_SIZE               (16u)
+#define LOGGER_BLOCKS                   (LOGGER_PAGES * LOGGER_PAGE_SIZE / LOGGER_BLOCK_SIZE)
+
+// Minutes between records
+#define LOGGER_INTERVAL                 (15u)
+
+// Page header marker, written last
+#define LOGGER_MAGIC                    (0x4C47u)
+
+// Records per page
+#define LOGGER_RECORDS                  ((LOGGER_PAGE_SIZE - sizeof(struct logger_page)) / \
+                                         sizeof(struct logger_record))
+
+// Record slot not written yet
+#define LOGGER_HOUR_FREE                (0xFFu)
+
+// *************************************************************************************************
+// Global Variable section
+
+// Page header (16 bytes). Page is valid only if magic is LOGGER_MAGIC.
+struct logger_page
+{
+    // Page sequence number, oldest page has lowest number
+    u16 seq;
+
+    // Date and time of first record
+    u16 year;
+    u8 month;
+    u8 day;
+    u8 hour;
+    u8 minute;
+
+    u8 reserved[6];
+
+    // LOGGER_MAGIC = page in use, other values = page must be erased before use
+    u16 magic;
+};
+
+// Record (10 bytes). Record is valid only if hour is not LOGGER_HOUR_FREE.
+struct logger_record
+{
+    // Pedometer count
+    u16 steps;
+
+    // Altitude (m)
+    s16 altitude;
+
+    // Temperature (0.1 degC)
+    s16 temperature;
+
+    // Battery voltage (10mV)
+    u16 voltage;
+
+    // Time of record, hour is written last
+    u8 minute;
+    u8 hour;
+};
+
+struct logger
+{
+    // Current page, LOGGER_PAGES = no page open
+    u8 page;
+
+    // Next free record in current page
+    u8 record;
+
+    // Sequence number of current page
+    u16 seq;
+};
+extern struct logger sLogger;
+
+// *************************************************************************************************
+// Extern section
+
+#endif                          /*LOGGER_H_ */
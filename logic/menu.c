@@ -59,6 +59,7 @@
 #include "rfbsl.h"
 #include "totp.h"
 #include "counter.h"
+#include "profile.h"
 
 // *************************************************************************************************
 // Defines section
@@ -121,7 +122,8 @@ u8 update_counter(void)
 //
 //      LINE1:  [Time] -> Alarm -> Temperature -> Altitude -> Heart rate -> Speed -> Acceleration
 //
-//      LINE2:  [Date] -> Stopwatch -> Battery  -> ACC -> PPT -> SYNC -> Calories/Distance --> RFBSL
+//      LINE2:  [Date] -> Stopwatch -> Counter -> Alt. session -> Battery  -> ACC -> PPT -> SYNC -> Calories/Distance --> RFBSL
+//                                                                     (--> Profile)
 // *************************************************************************************************
 
 // Line1 - Time
@@ -194,12 +196,21 @@ const struct menu menu_L1_Counter =
    FUNCTION( mx_counter ),
    FUNCTION( display_counter ),
    FUNCTION( update_counter ),
-   &menu_L2_Battery,
+   &menu_L2_AltSession,
+};
+
+// Line2 - Altitude session (total ascent/descent, max/min/average altitude, duration)
+const struct menu menu_L2_AltSession = {
+    FUNCTION(sx_altitude_session),    // direct function
+    FUNCTION(mx_altitude_session),    // sub menu function
+    FUNCTION(display_altitude_session), // display function
+    FUNCTION(update_time),            // new display data
+    &menu_L2_Battery,
 };
 
 // Line2 - Battery
 const struct menu menu_L2_Battery = {
-    FUNCTION(dummy),                  // direct function
+    FUNCTION(sx_battery),             // direct function
     FUNCTION(dummy),                  // sub menu function
     FUNCTION(display_battery_V),      // display function
     FUNCTION(update_battery_voltage), // new display data
@@ -219,7 +230,7 @@ const struct menu menu_L2_Totp =
 // Line2 - ACC (acceleration data + button events via SimpliciTI)
 const struct menu menu_L2_Rf = {
     FUNCTION(sx_rf),                  // direct function
-    FUNCTION(dummy),                  // sub menu function
+    FUNCTION(mx_rf),                  // sub menu function
     FUNCTION(display_rf),             // display function
     FUNCTION(update_time),            // new display data
     &menu_L2_Ppt,
@@ -249,5 +260,20 @@ const struct menu menu_L2_RFBSL = {
     FUNCTION(dummy),                  // sub menu function
     FUNCTION(display_rfbsl),          // display function
     FUNCTION(update_time),            // new display data
+#ifdef USE_PROFILING
+    &menu_L2_Profile,
+#else
+    &menu_L2_Date,
+#endif
+};
+
+#ifdef USE_PROFILING
+// Line2 - Run time statistics (hidden, build option USE_PROFILING)
+const struct menu menu_L2_Profile = {
+    FUNCTION(sx_profile),             // direct function
+    FUNCTION(mx_profile),             // sub menu function
+    FUNCTION(display_profile),        // display function
+    FUNCTION(update_time),            // new display data
     &menu_L2_Date,
 };
+#endif
@@ -77,12 +77,16 @@ extern const struct menu menu_L1_Acceleration;
 // Line2 navigation
 extern const struct menu menu_L2_Date;
 extern const struct menu menu_L2_Stopwatch;
+extern const struct menu menu_L2_AltSession;
 extern const struct menu menu_L2_Battery;
 extern const struct menu menu_L2_Totp;
 extern const struct menu menu_L2_Rf;
 extern const struct menu menu_L2_Ppt;
 extern const struct menu menu_L2_Sync;
 extern const struct menu menu_L2_RFBSL;
+#ifdef USE_PROFILING
+extern const struct menu menu_L2_Profile;
+#endif
 
 // Pointers to current menu item
 extern const struct menu *ptrMenu_L1;
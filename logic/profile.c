@@ -0,0 +1,173 @@
+// *************************************************************************************************
+// Run time statistics of interrupt handlers and tasks (build option USE_PROFILING).
+// *************************************************************************************************
+
+// *************************************************************************************************
+// Include section
+
+// system
+#include "project.h"
+
+// driver
+#include "display.h"
+
+// logic
+#include "profile.h"
+
+#ifdef USE_PROFILING
+
+// *************************************************************************************************
+// Prototypes section
+u16 profile_time(void);
+void profile_add(u8 entry, u16 ticks);
+void reset_profile(void);
+void sx_profile(u8 line);
+void mx_profile(u8 line);
+void display_profile(u8 line, u8 update);
+
+// *************************************************************************************************
+// Defines section
+
+// Conversion from Timer0 ticks to usec (1000000 / 32768 = 15625 / 512)
+#define CONV_TICKS_TO_US(ticks)         (((u32) (ticks) * 15625) >> 9)
+
+// *************************************************************************************************
+// Global Variable section
+struct profile sProfile;
+
+// *************************************************************************************************
+// Extern section
+
+// *************************************************************************************************
+// @fn          profile_time
+// @brief       Read free-running Timer0 counter.
+// @param       none
+// @return      u16             Timer0 counter (1 tick = 1/32768 sec)
+// *************************************************************************************************
+u16 profile_time(void)
+{
+    u16 value = 0;
+
+    // Timer0 runs from ACLK - to make sure this value is correctly read
+    while (value != TA0R)
+        value = TA0R;
+
+    return (value);
+}
+
+// *************************************************************************************************
+// @fn          profile_add
+// @brief       Add one run time to statistics. Called from interrupt handlers and main loop.
+// @param       u8 entry                PROFILE_xxx
+//                              u16 ticks               Run time (1 tick = 1/32768 sec)
+// @return      none
+// *************************************************************************************************
+void profile_add(u8 entry, u16 ticks)
+{
+    struct profile_entry *e = &sProfile.entry[entry];
+    u16 int_state;
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    if ((e->count == 0) || (ticks < e->min))
+        e->min = ticks;
+    if (ticks > e->max)
+        e->max = ticks;
+    e->sum += ticks;
+    e->count++;
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          reset_profile
+// @brief       Clear all statistics.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void reset_profile(void)
+{
+    u16 int_state;
+    u8 i;
+
+    int_state = __get_interrupt_state();
+    __disable_interrupt();
+
+    for (i = 0; i < PROFILE_ENTRIES; i++)
+    {
+        sProfile.entry[i].count = 0;
+        sProfile.entry[i].min = 0;
+        sProfile.entry[i].max = 0;
+        sProfile.entry[i].sum = 0;
+    }
+    sProfile.tick_errors = 0;
+
+    __set_interrupt_state(int_state);
+}
+
+// *************************************************************************************************
+// @fn          sx_profile
+// @brief       Profile direct function. Button DOWN shows next value.
+// @param       u8 line         LINE2
+// @return      none
+// *************************************************************************************************
+void sx_profile(u8 line)
+{
+    // Go to next view - max and average of each entry
+    if (++sProfile.view >= PROFILE_ENTRIES * 2)
+        sProfile.view = 0;
+}
+
+// *************************************************************************************************
+// @fn          mx_profile
+// @brief       Profile sub menu function. Long NUM press clears statistics.
+// @param       u8 line         LINE2
+// @return      none
+// *************************************************************************************************
+void mx_profile(u8 line)
+{
+    reset_profile();
+}
+
+// *************************************************************************************************
+// @fn          display_profile
+// @brief       Display routine for run time statistics. Shows entry number and longest (MAX
+//                              symbol) or average (AVERAGE symbol) run time in usec.
+// @param       u8 line                 LINE2
+//                              u8 update               DISPLAY_LINE_UPDATE_FULL,
+// DISPLAY_LINE_UPDATE_PARTIAL, DISPLAY_LINE_CLEAR
+// @return      none
+// *************************************************************************************************
+void display_profile(u8 line, u8 update)
+{
+    struct profile_entry *e = &sProfile.entry[sProfile.view / 2];
+    u16 ticks = 0;
+    u32 usec;
+
+    if ((update == DISPLAY_LINE_UPDATE_FULL) || (update == DISPLAY_LINE_UPDATE_PARTIAL))
+    {
+        display_symbol(LCD_SYMB_MAX, ((sProfile.view & 1) == 0) ? SEG_ON : SEG_OFF);
+        display_symbol(LCD_SYMB_AVERAGE, ((sProfile.view & 1) == 1) ? SEG_ON : SEG_OFF);
+
+        if ((sProfile.view & 1) == 0)
+            ticks = e->max;
+        else if (e->count > 0)
+            ticks = e->sum / e->count;
+
+        // Display entry number and run time in "n xxxx" format, limit to 4 digits
+        usec = CONV_TICKS_TO_US(ticks);
+        if (usec > 9999)
+            usec = 9999;
+        display_char(LCD_SEG_L2_4, '0' + sProfile.view / 2, SEG_ON);
+        display_chars(LCD_SEG_L2_3_0, int_to_array(usec, 4, 3), SEG_ON);
+    }
+    else if (update == DISPLAY_LINE_CLEAR)
+    {
+        // Clean up function-specific segments before leaving function
+        display_symbol(LCD_SYMB_MAX, SEG_OFF);
+        display_symbol(LCD_SYMB_AVERAGE, SEG_OFF);
+    }
+}
+
+#endif                          /* USE_PROFILING */
@@ -0,0 +1,81 @@
+// *************************************************************************************************
+// Run time statistics of interrupt handlers and tasks (build option USE_PROFILING).
+// *************************************************************************************************
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+// *************************************************************************************************
+// Include section
+
+// *************************************************************************************************
+// Prototypes section
+#ifdef USE_PROFILING
+extern u16 profile_time(void);
+extern void profile_add(u8 entry, u16 ticks);
+extern void reset_profile(void);
+extern void sx_profile(u8 line);
+extern void mx_profile(u8 line);
+extern void display_profile(u8 line, u8 update);
+#endif
+
+// *************************************************************************************************
+// Defines section
+
+// Measured interrupt handlers and tasks
+#define PROFILE_TIMER0_A0               (0u)
+#define PROFILE_TIMER0_A1_5             (1u)
+#define PROFILE_PORT2                   (2u)
+#define PROFILE_ADC12                   (3u)
+#define PROFILE_RTC_A                   (4u)
+#define PROFILE_REQUESTS                (5u)
+#define PROFILE_DISPLAY                 (6u)
+#define PROFILE_ENTRIES                 (7u)
+
+// Run time of a code section in Timer0 ticks (1 tick = 1/32768 sec), including any interrupts
+// serviced in between. Put PROFILE_ENTER() after the local declarations.
+#ifdef USE_PROFILING
+#define PROFILE_ENTER()                 u16 profile_enter = profile_time()
+#define PROFILE_EXIT(entry)             profile_add((entry), profile_time() - profile_enter)
+#else
+#define PROFILE_ENTER()
+#define PROFILE_EXIT(entry)
+#endif
+
+struct profile_entry
+{
+    // Number of calls
+    u32 count;
+
+    // Shortest and longest run time (ticks)
+    u16 min;
+    u16 max;
+
+    // Sum of all run times (ticks)
+    u32 sum;
+};
+
+struct profile
+{
+    struct profile_entry entry[PROFILE_ENTRIES];
+
+    // Entry and value (max / average) shown on LINE2
+    u8 view;
+
+    // Minute ticks at which an idle watch still had the 1 sec clock tick on - must stay 0
+    u16 tick_errors;
+
+    // Watch was idle at previous minute tick
+    u8 tick_idle;
+};
+
+// *************************************************************************************************
+// Global Variable section
+#ifdef USE_PROFILING
+extern struct profile sProfile;
+#endif
+
+// *************************************************************************************************
+// Extern section
+
+#endif                          /*PROFILE_H_ */
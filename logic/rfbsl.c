@@ -80,9 +80,12 @@ void sx_rfbsl(u8 line)
         clear_line(LINE1);
 
         // Write RAM to indicate we will be downloading the RAM Updater first
-        display_chars(LCD_SEG_L2_5_0, (u8 *) " RFBSL", SEG_ON);
+        display_bitmap(&lcd_bmp_rfbsl, SEG_ON);
         display_chars(LCD_SEG_L1_3_0, (u8 *) " RAM", SEG_ON);
 
+        // Show message before leaving application
+        lcd_commit();
+
         // Call RFBSL
         CALL_RFSBL();
     }
@@ -101,7 +104,7 @@ void display_rfbsl(u8 line, u8 update)
     {
         if (rfBSL_button_confirmation == 0)
         {
-            display_chars(LCD_SEG_L2_5_0, (u8 *) " RFBSL", SEG_ON);
+            display_bitmap(&lcd_bmp_rfbsl, SEG_ON);
         }
         else if (rfBSL_button_confirmation < 2)
         {
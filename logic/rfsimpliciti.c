@@ -49,7 +49,10 @@
 #include "ps.h"
 #include "ports.h"
 #include "timer.h"
+#include "rtc.h"
 #include "radio.h"
+#include "stack.h"
+#include "task.h"
 
 // logic
 #include "acceleration.h"
@@ -60,12 +63,22 @@
 #include "alarm.h"
 #include "temperature.h"
 #include "altitude.h"
+#include "delta.h"
+#include "profile.h"
+#include "logger.h"
+#include "user.h"
 
 // *************************************************************************************************
 // Prototypes section
 void simpliciti_get_data_callback(void);
 void start_simpliciti_tx_only(simpliciti_mode_t mode);
 void start_simpliciti_sync(void);
+PT_THREAD(mx_rf_flow(struct pt *pt));
+PT_THREAD(simpliciti_tx_only_flow(struct pt *pt));
+PT_THREAD(simpliciti_sync_flow(struct pt *pt));
+PT_THREAD(simpliciti_get_ed_data(struct pt *pt));
+void simpliciti_send_batch(void);
+void simpliciti_sent_ed_data_callback(void);
 
 // *************************************************************************************************
 // Defines section
@@ -93,8 +106,14 @@ unsigned char simpliciti_payload_length;
 //unsigned char simpliciti_reply;
 unsigned char simpliciti_reply_count;
 
+// 1 = send reply packets back-to-back and listen for ACK (windowed transfer)
+unsigned char simpliciti_reply_window;
+
+// Wake-on-radio interval (ms) requested by host
+unsigned int simpliciti_listen_interval;
+
 // 1 = send packets sequentially from burst_start to burst_end, 2 = send packets addressed by their
-// index
+// index, 3 = send packets of window starting at burst_start not acknowledged yet
 u8 burst_mode;
 
 // Start and end index of packets to send out
@@ -106,9 +125,24 @@ u16 burst_packet[BM_SYNC_BURST_PACKETS_IN_DATA];
 // Current packet index
 u8 burst_packet_index;
 
+// Packets of current window not acknowledged by access point (bit n = packet burst_start + n)
+u16 burst_window_missing;
+
+// Delta coded acceleration samples of current batch
+struct delta batch_delta;
+u8 batch_buf[SIMPLICITI_BATCH_BLOCK_SIZE];
+
+#ifdef USE_PROFILING
+// Requested run time statistics entry
+u8 profile_entry;
+#endif
+
 // *************************************************************************************************
 // Extern section
 extern void (*fptr_lcd_function_line1)(u8 line, u8 update);
+#ifndef MRFI_CC430
+extern void idle_loop(void);
+#endif
 
 // *************************************************************************************************
 // @fn          reset_rf
@@ -123,6 +157,9 @@ void reset_rf(void)
 
     // Standard packets are 4 bytes long
     simpliciti_payload_length = 4;
+
+    // Single sample acceleration packets
+    sRFsmpl.batch = 1;
 }
 
 // *************************************************************************************************
@@ -141,13 +178,70 @@ void sx_rf(u8 line)
     P2OUT &= ~BUTTON_BACKLIGHT_PIN;
     P2DIR &= ~BUTTON_BACKLIGHT_PIN;
 
+    // Backlight button is enabled again when the session has ended
     BUTTONS_IE &= ~BUTTON_BACKLIGHT_PIN;
 
     // Start SimpliciTI in tx only mode
     start_simpliciti_tx_only(SIMPLICITI_ACCELERATION);
+}
 
-    BUTTONS_IE |= BUTTON_BACKLIGHT_PIN;
+// *************************************************************************************************
+// @fn          mx_rf
+// @brief       Set maximum number of acceleration samples per packet. More samples per packet mean
+//                              less packets and radio time, but longer latency (30ms per sample).
+//                              Runs as foreground flow mx_rf_flow().
+// @param       u8 line         LINE2
+// @return      none
+// *************************************************************************************************
+void mx_rf(u8 line)
+{
+    task_flow_start(mx_rf_flow);
+}
+
+// *************************************************************************************************
+// @fn          mx_rf_flow
+// @brief       Batch size set flow.
+// @param       struct pt *pt   Protothread state
+// @return      u8              PT_WAITING, PT_ENDED
+// *************************************************************************************************
+PT_THREAD(mx_rf_flow(struct pt *pt))
+{
+    static s32 batch;
+
+    PT_BEGIN(pt);
+
+    batch = sRFsmpl.batch;
+
+    // Clear display
+    clear_line(LINE2);
+    display_chars(LCD_SEG_L2_5_2, (u8 *) "ACC ", SEG_ON);
+
+    // Loop values until all are set or user breaks set
+    while (1)
+    {
+        // Idle timeout: exit without saving
+        if (sys.flag.idle_timeout)
+            break;
+
+        // Button STAR (short): save, then exit
+        if (button.flag.star)
+        {
+            sRFsmpl.batch = batch;
+            break;
+        }
+
+        PT_SPAWN(pt, &sSetValue.pt, set_value(
+            &sSetValue.pt, &batch, 1, 0, 1, SIMPLICITI_BATCH_MAX, SETVALUE_ROLLOVER_VALUE +
+            SETVALUE_DISPLAY_VALUE, LCD_SEG_L2_0, display_value));
+    }
 
+    // Clear button flags
+    button.all_flags = 0;
+
+    // Redraw line
+    display.flag.line2_full_update = 1;
+
+    PT_END(pt);
 }
 
 // *************************************************************************************************
@@ -166,12 +260,11 @@ void sx_ppt(u8 line)
     P2OUT &= ~BUTTON_BACKLIGHT_PIN;
     P2DIR &= ~BUTTON_BACKLIGHT_PIN;
 
+    // Backlight button is enabled again when the session has ended
     BUTTONS_IE &= ~BUTTON_BACKLIGHT_PIN;
 
     // Start SimpliciTI in tx only mode
     start_simpliciti_tx_only(SIMPLICITI_BUTTONS);
-
-    BUTTONS_IE |= BUTTON_BACKLIGHT_PIN;
 }
 
 // *************************************************************************************************
@@ -190,39 +283,68 @@ void sx_sync(u8 line)
     P2OUT &= ~BUTTON_BACKLIGHT_PIN;
     P2DIR &= ~BUTTON_BACKLIGHT_PIN;
 
+    // Backlight button is enabled again when the session has ended
     BUTTONS_IE &= ~BUTTON_BACKLIGHT_PIN;
 
     // Start SimpliciTI in sync mode
     start_simpliciti_sync();
-
-    BUTTONS_IE |= BUTTON_BACKLIGHT_PIN;
 }
 
 // *************************************************************************************************
 // @fn          start_simpliciti_tx_only
-// @brief       Start SimpliciTI (tx only).
+// @brief       Start SimpliciTI (tx only). Session runs as foreground flow
+//                              simpliciti_tx_only_flow().
 // @param       simpliciti_state_t              SIMPLICITI_ACCELERATION, SIMPLICITI_BUTTONS
 // @return      none
 // *************************************************************************************************
 void start_simpliciti_tx_only(simpliciti_mode_t mode)
 {
+    if (is_task_flow())
+        return;
+
+    sRFsmpl.start_mode = mode;
+    task_flow_start(simpliciti_tx_only_flow);
+}
+
+// *************************************************************************************************
+// @fn          simpliciti_tx_only_flow
+// @brief       SimpliciTI tx only session. Exit with link timeout, SimpliciTI timeout or by a
+//                              button DOWN press.
+// @param       struct pt *pt   Protothread state
+// @return      u8              PT_WAITING, PT_ENDED
+// *************************************************************************************************
+PT_THREAD(simpliciti_tx_only_flow(struct pt *pt))
+{
+    simpliciti_mode_t mode = sRFsmpl.start_mode;
+
+    PT_BEGIN(pt);
+
     // Display time in line 1
     clear_line(LINE1);
     fptr_lcd_function_line1(LINE1, DISPLAY_LINE_CLEAR);
     display_time(LINE1, DISPLAY_LINE_UPDATE_FULL);
 
     // Preset simpliciti_data with mode (key or mouse click) and clear other data bytes
-    if (mode == SIMPLICITI_ACCELERATION)
+    if ((mode == SIMPLICITI_ACCELERATION) && (sRFsmpl.batch > 1))
+    {
+        simpliciti_data[0] = SIMPLICITI_MOUSE_BATCH_EVENTS;
+        simpliciti_payload_length = SIMPLICITI_BATCH_HEADER;
+    }
+    else if (mode == SIMPLICITI_ACCELERATION)
     {
         simpliciti_data[0] = SIMPLICITI_MOUSE_EVENTS;
+        simpliciti_payload_length = 4;
     }
     else
     {
         simpliciti_data[0] = SIMPLICITI_KEY_EVENTS;
+        simpliciti_payload_length = 4;
     }
     simpliciti_data[1] = 0;
     simpliciti_data[2] = 0;
     simpliciti_data[3] = 0;
+    sRFsmpl.samples = 0;
+    sRFsmpl.seq = 0;
 
     // Turn on beeper icon to show activity
     display_symbol(LCD_ICON_BEEPER1, SEG_ON_BLINK_ON);
@@ -230,7 +352,7 @@ void start_simpliciti_tx_only(simpliciti_mode_t mode)
     display_symbol(LCD_ICON_BEEPER3, SEG_ON_BLINK_ON);
 
     // Debounce button event
-    Timer0_A4_Delay(CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_OUT));
+    PT_DELAY(pt, CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_OUT));
 
     // Prepare radio for RF communication
     open_radio();
@@ -241,9 +363,17 @@ void start_simpliciti_tx_only(simpliciti_mode_t mode)
     // Set SimpliciTI timeout to save battery power
     sRFsmpl.timeout = SIMPLICITI_TIMEOUT;
 
+    // Timeout is counted by 1 sec clock tick
+    rtc_tick_second();
+
     // Start SimpliciTI stack. Try to link to access point.
     // Exit with timeout or by a button DOWN press.
-    if (simpliciti_link())
+#ifdef MRFI_CC430
+    PT_SPAWN(pt, &sRFsmpl.pt, simpliciti_link(&sRFsmpl.pt));
+#else
+    simpliciti_link();
+#endif
+    if (getFlag(simpliciti_flag, SIMPLICITI_STATUS_LINKED))
     {
         if (mode == SIMPLICITI_ACCELERATION)
         {
@@ -260,7 +390,11 @@ void start_simpliciti_tx_only(simpliciti_mode_t mode)
 
         // Enter TX only routine. This will transfer button events and/or acceleration data to
         // access point.
+#ifdef MRFI_CC430
+        PT_SPAWN(pt, &sRFsmpl.pt, simpliciti_main_tx_only(&sRFsmpl.pt));
+#else
         simpliciti_main_tx_only();
+#endif
     }
 
     // Set SimpliciTI state to OFF
@@ -280,9 +414,10 @@ void start_simpliciti_tx_only(simpliciti_mode_t mode)
     close_radio();
 
     // Clear last button events
-    Timer0_A4_Delay(CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_OUT));
+    PT_DELAY(pt, CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_OUT));
     BUTTONS_IFG = 0x00;
     button.all_flags = 0;
+    BUTTONS_IE |= BUTTON_BACKLIGHT_PIN;
 
     // Clear icons
     display_symbol(LCD_ICON_BEEPER1, SEG_OFF_BLINK_OFF);
@@ -293,8 +428,7 @@ void start_simpliciti_tx_only(simpliciti_mode_t mode)
     clear_line(LINE1);
     display_time(LINE1, DISPLAY_LINE_CLEAR);
 
-    // Force full display update
-    display.flag.full_update = 1;
+    PT_END(pt);
 }
 
 // *************************************************************************************************
@@ -308,7 +442,7 @@ void display_rf(u8 line, u8 update)
 {
     if (update == DISPLAY_LINE_UPDATE_FULL)
     {
-        display_chars(LCD_SEG_L2_5_0, (u8 *) "   ACC", SEG_ON);
+        display_bitmap(&lcd_bmp_acc, SEG_ON);
     }
 }
 
@@ -338,7 +472,7 @@ void display_sync(u8 line, u8 update)
 {
     if (update == DISPLAY_LINE_UPDATE_FULL)
     {
-        display_chars(LCD_SEG_L2_5_0, (u8 *) "  SYNC", SEG_ON);
+        display_bitmap(&lcd_bmp_sync, SEG_ON);
     }
 }
 
@@ -354,29 +488,28 @@ u8 is_rf(void)
 }
 
 // *************************************************************************************************
-// @fn          simpliciti_get_ed_data_callback
-// @brief       Callback function to read end device data from acceleration sensor (if available)
-//                              and trigger sending. Can be also be used to transmit other data at
-// different packet rates.
+// @fn          simpliciti_get_ed_data
+// @brief       Read end device data from acceleration sensor (if available) and trigger sending.
+//                              Can be also be used to transmit other data at different packet
+//                              rates.
 //                              Please observe the applicable duty limit in the chosen ISM band.
-// @param       none
-// @return      none
+// @param       struct pt *pt   Protothread state
+// @return      u8              PT_WAITING, PT_ENDED
 // *************************************************************************************************
-void simpliciti_get_ed_data_callback(void)
+PT_THREAD(simpliciti_get_ed_data(struct pt *pt))
 {
     static u8 packet_counter = 0;
 
+    PT_BEGIN(pt);
+
     if (sRFsmpl.mode == SIMPLICITI_ACCELERATION)
     {
         // Wait for next sample
-        Timer0_A4_Delay(CONV_MS_TO_TICKS(5));
+        PT_DELAY(pt, CONV_MS_TO_TICKS(5));
 
-        // Read from sensor if EOC pin indicates new data (set in PORT2 ISR)
-        if (request.flag.acceleration_measurement)
+        // Read from sensor if EOC pin indicates new data
+        if ((AS_INT_IN & AS_INT_PIN) == AS_INT_PIN)
         {
-            // Clear flag
-            request.flag.acceleration_measurement = 0;
-
             // Get data from sensor
         	if (bmp_used)
         	{
@@ -387,19 +520,49 @@ void simpliciti_get_ed_data_callback(void)
                 cma_as_get_data(sAccel.xyz);
         	}
 
-            // Transmit only every 3rd data set (= 33 packets / second)
+            // Transmit only every 3rd data set (= 33 samples / second)
             if (packet_counter++ > 1)
             {
                 // Reset counter
                 packet_counter = 0;
 
-                // Store XYZ data in SimpliciTI variable
-                simpliciti_data[1] = sAccel.xyz[0];
-                simpliciti_data[2] = sAccel.xyz[1];
-                simpliciti_data[3] = sAccel.xyz[2];
-
-                // Trigger packet sending
-                simpliciti_flag |= SIMPLICITI_TRIGGER_SEND_DATA;
+                if (sRFsmpl.batch > 1)
+                {
+                    // Collect XYZ data in delta coded block
+                    if (sRFsmpl.samples == 0)
+                    {
+                        delta_start(&batch_delta, batch_buf, sizeof(batch_buf), 3, sAccel.xyz);
+                        sRFsmpl.samples = 1;
+                    }
+                    else if (delta_put(&batch_delta, sAccel.xyz))
+                    {
+                        sRFsmpl.samples++;
+                    }
+                    else
+                    {
+                        // Block is full: send it, sample starts next block
+                        simpliciti_send_batch();
+                        delta_start(&batch_delta, batch_buf, sizeof(batch_buf), 3, sAccel.xyz);
+                        sRFsmpl.samples = 1;
+                    }
+
+                    // Send packet when batch is complete (= 33 / batch packets / second)
+                    if (sRFsmpl.samples == sRFsmpl.batch)
+                    {
+                        simpliciti_send_batch();
+                        sRFsmpl.samples = 0;
+                    }
+                }
+                else
+                {
+                    // Store XYZ data in SimpliciTI variable
+                    simpliciti_data[1] = sAccel.xyz[0];
+                    simpliciti_data[2] = sAccel.xyz[1];
+                    simpliciti_data[3] = sAccel.xyz[2];
+
+                    // Trigger packet sending
+                    simpliciti_flag |= SIMPLICITI_TRIGGER_SEND_DATA;
+                }
             }
         }
     }
@@ -422,15 +585,14 @@ void simpliciti_get_ed_data_callback(void)
             else
             {
                 // Trigger packet sending in regular intervals
-                Timer0_A4_Delay(CONV_MS_TO_TICKS(30));
+                PT_DELAY(pt, CONV_MS_TO_TICKS(30));
                 simpliciti_flag |= SIMPLICITI_TRIGGER_SEND_DATA;
             }
         }
         else
         {
             // Wait in LPM3 for next button press
-            _BIS_SR(LPM3_bits + GIE);
-            __no_operation();
+            PT_SLEEP(pt);
         }
     }
 
@@ -439,22 +601,93 @@ void simpliciti_get_ed_data_callback(void)
     {
         display_time(LINE1, DISPLAY_LINE_UPDATE_PARTIAL);
         display.flag.update_time = 0;
+    }
 
-#ifdef USE_WATCHDOG
-        // Service watchdog
-        WDTCTL = WDTPW + WDTIS__512K + WDTSSEL__ACLK + WDTCNTCL;
+    PT_END(pt);
+}
+
+#ifndef MRFI_CC430
+// *************************************************************************************************
+// @fn          simpliciti_get_ed_data_callback
+// @brief       Called by the prebuilt SimpliciTI library, which runs the whole session as one
+//                              blocking loop. Waits of simpliciti_get_ed_data() are spent in
+//                              idle_loop().
+// @param       none
+// @return      none
+// *************************************************************************************************
+void simpliciti_get_ed_data_callback(void)
+{
+    struct pt pt;
+
+    PT_INIT(&pt);
+    while (simpliciti_get_ed_data(&pt) != PT_ENDED)
+        idle_loop();
+}
 #endif
+
+// *************************************************************************************************
+// @fn          simpliciti_send_batch
+// @brief       Copy delta coded acceleration block to packet and trigger sending.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void simpliciti_send_batch(void)
+{
+    u8 i;
+    u8 length = delta_length(&batch_delta);
+
+    // Sequence number lets access point detect lost packets
+    simpliciti_data[1] = sRFsmpl.seq++;
+    simpliciti_data[2] = sRFsmpl.samples;
+    for (i = 0; i < length; i++)
+    {
+        simpliciti_data[SIMPLICITI_BATCH_HEADER + i] = batch_buf[i];
+    }
+    simpliciti_payload_length = SIMPLICITI_BATCH_HEADER + length;
+
+    // Trigger packet sending
+    simpliciti_flag |= SIMPLICITI_TRIGGER_SEND_DATA;
+}
+
+// *************************************************************************************************
+// @fn          simpliciti_sent_ed_data_callback
+// @brief       Called by SimpliciTI after a packet was sent. A batch is sent only once - a packet
+//                              triggered by a button afterwards carries the header without samples.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void simpliciti_sent_ed_data_callback(void)
+{
+    if ((simpliciti_data[0] & 0x0F) == SIMPLICITI_MOUSE_BATCH_EVENTS)
+    {
+        simpliciti_data[2] = 0;
+        simpliciti_payload_length = SIMPLICITI_BATCH_HEADER;
     }
 }
 
 // *************************************************************************************************
 // @fn          start_simpliciti_sync
-// @brief       Start SimpliciTI (sync mode).
+// @brief       Start SimpliciTI (sync mode). Session runs as foreground flow
+//                              simpliciti_sync_flow().
 // @param       none
 // @return      none
 // *************************************************************************************************
 void start_simpliciti_sync(void)
 {
+    task_flow_start(simpliciti_sync_flow);
+}
+
+// *************************************************************************************************
+// @fn          simpliciti_sync_flow
+// @brief       SimpliciTI sync session. Exit with link timeout, SimpliciTI timeout or by a button
+//                              DOWN press.
+// @param       struct pt *pt   Protothread state
+// @return      u8              PT_WAITING, PT_ENDED
+// *************************************************************************************************
+PT_THREAD(simpliciti_sync_flow(struct pt *pt))
+{
+    PT_BEGIN(pt);
+
     // Clear LINE1
     clear_line(LINE1);
     fptr_lcd_function_line1(LINE1, DISPLAY_LINE_CLEAR);
@@ -482,7 +715,7 @@ void start_simpliciti_sync(void)
     display_symbol(LCD_ICON_BEEPER3, SEG_ON_BLINK_ON);
 
     // Debounce button event
-    Timer0_A4_Delay(CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_OUT));
+    PT_DELAY(pt, CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_OUT));
 
     // Prepare radio for RF communication
     open_radio();
@@ -493,14 +726,26 @@ void start_simpliciti_sync(void)
     // Set SimpliciTI timeout to save battery power
     sRFsmpl.timeout = SIMPLICITI_TIMEOUT;
 
+    // Timeout is counted by 1 sec clock tick
+    rtc_tick_second();
+
     // Start SimpliciTI stack. Try to link to access point.
     // Exit with timeout or by a button DOWN press.
-    if (simpliciti_link())
+#ifdef MRFI_CC430
+    PT_SPAWN(pt, &sRFsmpl.pt, simpliciti_link(&sRFsmpl.pt));
+#else
+    simpliciti_link();
+#endif
+    if (getFlag(simpliciti_flag, SIMPLICITI_STATUS_LINKED))
     {
         // Enter sync routine. This will send ready-to-receive packets at regular intervals to the
         // access point.
         // The access point replies with a command (NOP if no other command is set)
+#ifdef MRFI_CC430
+        PT_SPAWN(pt, &sRFsmpl.pt, simpliciti_main_sync(&sRFsmpl.pt));
+#else
         simpliciti_main_sync();
+#endif
     }
 
     // Set SimpliciTI state to OFF
@@ -510,17 +755,17 @@ void start_simpliciti_sync(void)
     close_radio();
 
     // Clear last button events
-    Timer0_A4_Delay(CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_OUT));
+    PT_DELAY(pt, CONV_MS_TO_TICKS(BUTTONS_DEBOUNCE_TIME_OUT));
     BUTTONS_IFG = 0x00;
     button.all_flags = 0;
+    BUTTONS_IE |= BUTTON_BACKLIGHT_PIN;
 
     // Clear icons
     display_symbol(LCD_ICON_BEEPER1, SEG_OFF_BLINK_OFF);
     display_symbol(LCD_ICON_BEEPER2, SEG_OFF_BLINK_OFF);
     display_symbol(LCD_ICON_BEEPER3, SEG_OFF_BLINK_OFF);
 
-    // Force full display update
-    display.flag.full_update = 1;
+    PT_END(pt);
 }
 
 // *************************************************************************************************
@@ -536,6 +781,7 @@ void simpliciti_sync_decode_ap_cmd_callback(void)
 
     // Default behaviour is to send no reply packets
     simpliciti_reply_count = 0;
+    simpliciti_reply_window = 0;
 
     switch (simpliciti_data[0])
     {
@@ -558,6 +804,9 @@ void simpliciti_sync_decode_ap_cmd_callback(void)
             sDate.day = simpliciti_data[7];
             sAlarm.hour = simpliciti_data[8];
             sAlarm.minute = simpliciti_data[9];
+            rtc_set_time(sTime.hour, sTime.minute, sTime.second);
+            rtc_set_date(sDate.year, sDate.month, sDate.day);
+            rtc_set_alarm(sAlarm.hour, sAlarm.minute);
             // Set temperature and temperature offset
             t1 = (s16) ((simpliciti_data[10] << 8) + simpliciti_data[11]);
             offset = t1 - (sTemp.degrees - sTemp.offset);
@@ -566,8 +815,11 @@ void simpliciti_sync_decode_ap_cmd_callback(void)
             // Set altitude
             sAlt.altitude = (s16) ((simpliciti_data[12] << 8) + simpliciti_data[13]);
             update_pressure_table(sAlt.altitude, sAlt.pressure, sAlt.temperature);
+            rebase_altitude_session(sAlt.altitude);
+            // Start new data log page with new time
+            logger_rebase();
 
-            display_chars(LCD_SEG_L2_5_0, (u8 *) "  DONE", SEG_ON);
+            display_bitmap(&lcd_bmp_done, SEG_ON);
             sRFsmpl.display_sync_done = 1;
             break;
 
@@ -597,7 +849,61 @@ void simpliciti_sync_decode_ap_cmd_callback(void)
             simpliciti_reply_count = BM_SYNC_BURST_PACKETS_IN_DATA;
             break;
 
+        case SYNC_AP_CMD_GET_MEMORY_WINDOW:
+            // Send window of sequential packets back-to-back, then wait for ACK
+            simpliciti_data[0] = SYNC_ED_TYPE_MEMORY;
+            burst_start = (simpliciti_data[1] << 8) + simpliciti_data[2];
+            t1 = simpliciti_data[3];
+            if (t1 > SYNC_WINDOW_MAX)
+                t1 = SYNC_WINDOW_MAX;
+            burst_window_missing = (t1 == SYNC_WINDOW_MAX) ? 0xFFFF : ((1u << t1) - 1);
+            burst_mode = 3;
+            simpliciti_reply_count = t1;
+            simpliciti_reply_window = 1;
+            break;
+
+        case SYNC_AP_CMD_ACK_MEMORY_WINDOW:
+            // Resend packets of current window that access point has not received
+            simpliciti_data[0] = SYNC_ED_TYPE_MEMORY;
+            if (burst_mode == 3)
+            {
+                burst_window_missing &= ~((simpliciti_data[1] << 8) + simpliciti_data[2]);
+                for (i = 0; i < SYNC_WINDOW_MAX; i++)
+                {
+                    if (burst_window_missing & (1u << i))
+                        simpliciti_reply_count++;
+                }
+            }
+            simpliciti_reply_window = 1;
+            break;
+
+        case SYNC_AP_CMD_LISTEN:     // Stop polling, wait until host wakes watch up by radio
+            simpliciti_listen_interval = (simpliciti_data[1] << 8) + simpliciti_data[2];
+            break;
+
         case SYNC_AP_CMD_ERASE_MEMORY: // Erase data logger memory
+            logger_erase();
+            break;
+
+        case SYNC_AP_CMD_GET_ALTITUDE_SESSION: // Send altitude session statistics
+            simpliciti_data[0] = SYNC_ED_TYPE_ALTITUDE_SESSION;
+            // Send single reply packet
+            simpliciti_reply_count = 1;
+            break;
+
+#ifdef USE_PROFILING
+        case SYNC_AP_CMD_GET_PROFILE: // Send run time statistics of one handler / task
+            profile_entry = simpliciti_data[1];
+            simpliciti_data[0] = SYNC_ED_TYPE_PROFILE;
+            // Send single reply packet
+            simpliciti_reply_count = 1;
+            break;
+#endif
+
+        case SYNC_AP_CMD_GET_RAM:      // Send RAM usage and stack high-water mark
+            simpliciti_data[0] = SYNC_ED_TYPE_RAM;
+            // Send single reply packet
+            simpliciti_reply_count = 1;
             break;
 
         case SYNC_AP_CMD_EXIT:         // Exit sync mode
@@ -616,6 +922,12 @@ void simpliciti_sync_decode_ap_cmd_callback(void)
 void simpliciti_sync_get_data_callback(unsigned int index)
 {
     u8 i;
+    s16 t1;
+    u16 t2;
+#ifdef USE_PROFILING
+    struct profile_entry pe = { 0, 0, 0, 0 };
+    u16 int_state;
+#endif
 
     // simpliciti_data[0] contains data type and needs to be returned to AP
     switch (simpliciti_data[0])
@@ -634,6 +946,74 @@ void simpliciti_sync_get_data_callback(unsigned int index)
             simpliciti_data[11] = sTemp.degrees & 0xFF;
             simpliciti_data[12] = sAlt.altitude >> 8;
             simpliciti_data[13] = sAlt.altitude & 0xFF;
+            simpliciti_data[14] = LOGGER_BLOCKS >> 8;
+            simpliciti_data[15] = LOGGER_BLOCKS & 0xFF;
+            break;
+
+        case SYNC_ED_TYPE_ALTITUDE_SESSION: // Assemble altitude session packet
+            simpliciti_data[1] = sAltSession.ascent >> 8;
+            simpliciti_data[2] = sAltSession.ascent & 0xFF;
+            simpliciti_data[3] = sAltSession.descent >> 8;
+            simpliciti_data[4] = sAltSession.descent & 0xFF;
+            simpliciti_data[5] = sAltSession.max >> 8;
+            simpliciti_data[6] = sAltSession.max & 0xFF;
+            simpliciti_data[7] = sAltSession.min >> 8;
+            simpliciti_data[8] = sAltSession.min & 0xFF;
+            t1 = get_altitude_session_average();
+            simpliciti_data[9] = t1 >> 8;
+            simpliciti_data[10] = t1 & 0xFF;
+            simpliciti_data[11] = (sAltSession.duration >> 24) & 0xFF;
+            simpliciti_data[12] = (sAltSession.duration >> 16) & 0xFF;
+            simpliciti_data[13] = (sAltSession.duration >> 8) & 0xFF;
+            simpliciti_data[14] = sAltSession.duration & 0xFF;
+            simpliciti_data[15] = (sAltSession.samples >> 24) & 0xFF;
+            simpliciti_data[16] = (sAltSession.samples >> 16) & 0xFF;
+            simpliciti_data[17] = (sAltSession.samples >> 8) & 0xFF;
+            simpliciti_data[18] = sAltSession.samples & 0xFF;
+            break;
+
+#ifdef USE_PROFILING
+        case SYNC_ED_TYPE_PROFILE: // Assemble run time statistics packet (Timer0 ticks)
+            if (profile_entry < PROFILE_ENTRIES)
+            {
+                // Read consistent copy of entry
+                int_state = __get_interrupt_state();
+                __disable_interrupt();
+                pe = sProfile.entry[profile_entry];
+                __set_interrupt_state(int_state);
+            }
+            simpliciti_data[1] = profile_entry;
+            simpliciti_data[2] = PROFILE_ENTRIES;
+            simpliciti_data[3] = (pe.count >> 24) & 0xFF;
+            simpliciti_data[4] = (pe.count >> 16) & 0xFF;
+            simpliciti_data[5] = (pe.count >> 8) & 0xFF;
+            simpliciti_data[6] = pe.count & 0xFF;
+            simpliciti_data[7] = pe.min >> 8;
+            simpliciti_data[8] = pe.min & 0xFF;
+            simpliciti_data[9] = pe.max >> 8;
+            simpliciti_data[10] = pe.max & 0xFF;
+            simpliciti_data[11] = (pe.sum >> 24) & 0xFF;
+            simpliciti_data[12] = (pe.sum >> 16) & 0xFF;
+            simpliciti_data[13] = (pe.sum >> 8) & 0xFF;
+            simpliciti_data[14] = pe.sum & 0xFF;
+            simpliciti_data[15] = sProfile.tick_errors >> 8;
+            simpliciti_data[16] = sProfile.tick_errors & 0xFF;
+            break;
+#endif
+
+        case SYNC_ED_TYPE_RAM: // Assemble RAM usage packet (bytes)
+            t2 = ram_get_static();
+            simpliciti_data[1] = t2 >> 8;
+            simpliciti_data[2] = t2 & 0xFF;
+            t2 = stack_get_size();
+            simpliciti_data[3] = t2 >> 8;
+            simpliciti_data[4] = t2 & 0xFF;
+            t2 = stack_get_peak();
+            simpliciti_data[5] = t2 >> 8;
+            simpliciti_data[6] = t2 & 0xFF;
+            t2 = ram_get_free();
+            simpliciti_data[7] = t2 >> 8;
+            simpliciti_data[8] = t2 & 0xFF;
             break;
 
         case SYNC_ED_TYPE_MEMORY:
@@ -643,8 +1023,7 @@ void simpliciti_sync_get_data_callback(unsigned int index)
                 simpliciti_data[1] = ((burst_start + index) >> 8) & 0xFF;
                 simpliciti_data[2] = (burst_start + index) & 0xFF;
                 // Assemble payload
-                for (i = 3; i < BM_SYNC_DATA_LENGTH; i++)
-                    simpliciti_data[i] = index;
+                logger_get_block(burst_start + index, &simpliciti_data[3]);
             }
             else if (burst_mode == 2)
             {
@@ -652,8 +1031,21 @@ void simpliciti_sync_get_data_callback(unsigned int index)
                 simpliciti_data[1] = (burst_packet[index] >> 8) & 0xFF;
                 simpliciti_data[2] = burst_packet[index] & 0xFF;
                 // Assemble payload
-                for (i = 3; i < BM_SYNC_DATA_LENGTH; i++)
-                    simpliciti_data[i] = index;
+                logger_get_block(burst_packet[index], &simpliciti_data[3]);
+            }
+            else if (burst_mode == 3)
+            {
+                // Find index-th packet not acknowledged yet
+                for (i = 0; i < SYNC_WINDOW_MAX; i++)
+                {
+                    if ((burst_window_missing & (1u << i)) && (index-- == 0))
+                        break;
+                }
+                // Set burst packet address
+                simpliciti_data[1] = ((burst_start + i) >> 8) & 0xFF;
+                simpliciti_data[2] = (burst_start + i) & 0xFF;
+                // Assemble payload
+                logger_get_block(burst_start + i, &simpliciti_data[3]);
             }
             break;
     }
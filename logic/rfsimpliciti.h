@@ -38,11 +38,13 @@
 
 // *************************************************************************************************
 // Include section
+#include "pt.h"
 
 // *************************************************************************************************
 // Prototypes section
 extern void reset_rf(void);
 extern void sx_rf(u8 line);
+extern void mx_rf(u8 line);
 extern void sx_ppt(u8 line);
 extern void sx_sync(u8 line);
 extern void display_rf(u8 line, u8 update);
@@ -74,6 +76,21 @@ typedef enum
 // SimpliciTI mode flag
 #define SIMPLICITI_MOUSE_EVENTS                 (0x01)
 #define SIMPLICITI_KEY_EVENTS                   (0x02)
+#define SIMPLICITI_MOUSE_BATCH_EVENTS           (0x03)
+
+// Batched acceleration packets (access point format, see README):
+//      byte 0          SIMPLICITI_MOUSE_BATCH_EVENTS | button flags
+//      byte 1          sequence number, +1 per batch
+//      byte 2          sample count (0 = button event only, no samples)
+//      byte 3..        delta coded xyz samples (delta.h), oldest first, up to 16 bytes
+#define SIMPLICITI_BATCH_HEADER                 (3u)
+#define SIMPLICITI_BATCH_BLOCK_SIZE             (16u)
+#ifdef MRFI_CC430
+#define SIMPLICITI_BATCH_MAX                    (5u)
+#else
+// SimpliciTI library sends fixed 4 byte packets
+#define SIMPLICITI_BATCH_MAX                    (1u)
+#endif
 
 // *************************************************************************************************
 // Global Variable section
@@ -87,6 +104,17 @@ struct RFsmpl
 
     // Variable to display
     u8 display_sync_done;
+
+    // Acceleration samples per packet (1 = single sample packets), collected samples, sequence
+    u8 batch;
+    u8 samples;
+    u8 seq;
+
+    // Mode of tx only session to start
+    simpliciti_mode_t start_mode;
+
+    // SimpliciTI link / session protothread state
+    struct pt pt;
 };
 extern struct RFsmpl sRFsmpl;
 
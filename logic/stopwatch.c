@@ -61,6 +61,7 @@ void update_stopwatch_timer(void);
 void mx_stopwatch(u8 line);
 void sx_stopwatch(u8 line);
 void display_stopwatch(u8 line, u8 update);
+PT_THREAD(task_stopwatch(struct pt *pt));
 
 // *************************************************************************************************
 // Defines section
@@ -441,3 +442,24 @@ void display_stopwatch(u8 line, u8 update)
     }
 }
 
+// *************************************************************************************************
+// @fn          task_stopwatch
+// @brief       Background task. Redraws running stopwatch while main loop is blocked, e.g. while
+//                              waiting in Timer0_A4_Delay().
+// @param       struct pt *pt   Protothread state
+// @return      u8              PT_WAITING
+// *************************************************************************************************
+PT_THREAD(task_stopwatch(struct pt *pt))
+{
+    PT_BEGIN(pt);
+
+    while (1)
+    {
+        PT_WAIT_UNTIL(pt, display.flag.update_stopwatch && is_stopwatch() && !message.all_flags);
+
+        display_stopwatch(LINE2, DISPLAY_LINE_UPDATE_PARTIAL);
+        display.flag.update_stopwatch = 0;
+    }
+
+    PT_END(pt);
+}
@@ -39,6 +39,7 @@
 // *************************************************************************************************
 // Include section
 #include <project.h>
+#include "pt.h"
 
 // *************************************************************************************************
 // Prototypes section
@@ -51,6 +52,7 @@ extern void update_stopwatch_timer(void);
 extern void mx_stopwatch(u8 line);
 extern void sx_stopwatch(u8 line);
 extern void display_stopwatch(u8 line, u8 update);
+extern PT_THREAD(task_stopwatch(struct pt *pt));
 
 // *************************************************************************************************
 // Defines section
@@ -47,6 +47,8 @@
 #include "display.h"
 #include "adc12.h"
 #include "timer.h"
+#include "event.h"
+#include "task.h"
 
 // logic
 #include "user.h"
@@ -56,6 +58,7 @@
 u8 is_temp_measurement(void);
 s16 convert_C_to_F(s16 value);
 s16 convert_F_to_C(s16 value);
+PT_THREAD(mx_temperature_flow(struct pt *pt));
 
 // *************************************************************************************************
 // Defines section
@@ -167,19 +170,44 @@ u8 is_temp_measurement(void)
     return (sTemp.state == MENU_ITEM_VISIBLE);
 }
 
+// *************************************************************************************************
+// @fn          tick_temperature
+// @brief       Timer job while temperature menu item is active. Requests a temperature measurement.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void tick_temperature(void)
+{
+    event_post(EVENT_TEMPERATURE_MEASUREMENT, FILTER_ON);
+}
+
 // *************************************************************************************************
 // @fn          mx_temperature
-// @brief       Mx button handler to set the temperature offset.
+// @brief       Mx button handler to set the temperature offset. Runs as foreground flow
+//                              mx_temperature_flow().
 // @param       u8 line         LINE1
 // @return      none
 // *************************************************************************************************
 void mx_temperature(u8 line)
 {
-    s32 temperature;
-    s16 temperature0;
+    task_flow_start(mx_temperature_flow);
+}
+
+// *************************************************************************************************
+// @fn          mx_temperature_flow
+// @brief       Temperature offset set flow.
+// @param       struct pt *pt   Protothread state
+// @return      u8              PT_WAITING, PT_ENDED
+// *************************************************************************************************
+PT_THREAD(mx_temperature_flow(struct pt *pt))
+{
+    static s32 temperature;
+    static s16 temperature0;
     volatile s16 temperature1;
     volatile s16 offset;
 
+    PT_BEGIN(pt);
+
     // Clear display
     clear_display_all();
 
@@ -240,13 +268,15 @@ void mx_temperature(u8 line)
         display_symbol(LCD_UNIT_L1_DEGREE, SEG_ON);
 
         // Set current temperature - offset is set when leaving function
-        set_value(&temperature, 3, 1, -999, 999, SETVALUE_DISPLAY_VALUE + SETVALUE_DISPLAY_ARROWS,
-                  LCD_SEG_L1_3_1,
-                  display_value);
+        PT_SPAWN(pt, &sSetValue.pt, set_value(
+            &sSetValue.pt, &temperature, 3, 1, -999, 999, SETVALUE_DISPLAY_VALUE +
+            SETVALUE_DISPLAY_ARROWS, LCD_SEG_L1_3_1, display_value));
     }
 
     // Clear button flags
     button.all_flags = 0;
+
+    PT_END(pt);
 }
 
 // *************************************************************************************************
@@ -267,6 +297,9 @@ void display_temperature(u8 line, u8 update)
         // Menu item is visible
         sTemp.state = MENU_ITEM_VISIBLE;
 
+        // Measure temperature each second
+        timer_job_start(TIMER_JOB_TEMPERATURE, tick_temperature, 1, TIMER_JOB_PERIODIC);
+
         // Display C / F
         display_symbol(LCD_SEG_L1_DP1, SEG_ON);
         display_symbol(LCD_UNIT_L1_DEGREE, SEG_ON);
@@ -322,6 +355,9 @@ void display_temperature(u8 line, u8 update)
         // Menu item is not visible
         sTemp.state = MENU_ITEM_NOT_VISIBLE;
 
+        // Stop measurement
+        timer_job_stop(TIMER_JOB_TEMPERATURE);
+
         // Clean up function-specific segments before leaving function
         display_symbol(LCD_SYMB_ARROW_UP, SEG_OFF);
         display_symbol(LCD_SYMB_ARROW_DOWN, SEG_OFF);
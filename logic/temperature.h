@@ -45,6 +45,7 @@
 // internal functions
 extern void reset_temp_measurement(void);
 extern u8 is_temp_measurement(void);
+extern void tick_temperature(void);
 extern void temperature_measurement(u8 filter);
 
 // menu functions
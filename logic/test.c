@@ -50,6 +50,7 @@
 #include "ps.h"
 #include "ports.h"
 #include "timer.h"
+#include "rtc.h"
 
 // logic
 #include "acceleration.h"
@@ -76,8 +77,9 @@ void test_mode(void)
     u8 *str;
     u8 i;
 
-    // Disable timer - no need for a clock tick
+    // Disable timer and RTC - no need for a clock tick
     Timer0_Stop();
+    rtc_stop();
 
     // Disable LCD charge pump while in standby mode
     // This reduces current consumption by ca. 5A to ca. 10A
@@ -102,6 +104,7 @@ void test_mode(void)
     WDTCTL = WDTPW + WDTHOLD;
 
     // Wait for button press
+    lcd_commit();
     _BIS_SR(LPM3_bits + GIE);
     __no_operation();
 
@@ -114,8 +117,9 @@ void test_mode(void)
     LCDBVCTL = LCDCPEN | VLCD_2_72;
 #endif
 
-    // Renenable timer
+    // Renenable timer and RTC
     Timer0_Start();
+    rtc_start();
 
     // Debounce button press
     Timer0_A4_Delay(CONV_MS_TO_TICKS(100));
@@ -238,8 +242,9 @@ void test_mode(void)
                     // Debounce button press
                     Timer0_A4_Delay(CONV_MS_TO_TICKS(500));
 
-                    // Disable timer - no need for a clock tick
+                    // Disable timer and RTC - no need for a clock tick
                     Timer0_Stop();
+                    rtc_stop();
 
                     // Hold watchdog
                     WDTCTL = WDTPW + WDTHOLD;
@@ -257,6 +262,7 @@ void test_mode(void)
                 WDTCTL = WDTPW + WDTIS__512K + WDTSSEL__ACLK + WDTCNTCL;
 #endif
                 // To LPM3
+                lcd_commit();
                 _BIS_SR(LPM3_bits + GIE);
                 __no_operation();
             }
@@ -283,14 +289,13 @@ void test_mode(void)
 // *************************************************************************************************
 void display_all_on(void)
 {
-    u8 *lcdptr = (u8 *) 0x0A20;
     u8 i;
 
-    for (i = 1; i <= 12; i++)
+    for (i = 0; i < LCD_MEM_SIZE; i++)
     {
-        *lcdptr = 0xFF;
-        lcdptr++;
+        write_lcd_mem(LCD_MEM_1 + i, 0xFF, 0xFF, SEG_ON);
     }
+    lcd_commit();
 }
 
 // *************************************************************************************************
@@ -301,13 +306,12 @@ void display_all_on(void)
 // *************************************************************************************************
 void display_all_off(void)
 {
-    u8 *lcdptr = (u8 *) 0x0A20;
     u8 i;
 
-    for (i = 1; i <= 12; i++)
+    for (i = 0; i < LCD_MEM_SIZE; i++)
     {
-        *lcdptr = 0x00;
-        lcdptr++;
+        write_lcd_mem(LCD_MEM_1 + i, 0x00, 0xFF, SEG_ON);
     }
+    lcd_commit();
 }
 
@@ -3,6 +3,7 @@
 #include "project.h"
 #include "totp.h"
 #include "display.h"
+#include "timer.h"
 #include "clock.h"   // sTime
 #include "date.h"    // sDate
 #include "base32.h"
@@ -19,6 +20,7 @@ void reset_totp() {
 	stotp.dispseq = 0;
 	base32_decode((const u8 *)"YOUR SECRET KEY", stotp.key, 32); // create key from secret string
 	stotp.code    = 0;
+	timer_job_stop(TIMER_JOB_TOTP);
 }
 
 void set_totp(u8 line) {
@@ -36,6 +38,7 @@ void set_totp(u8 line) {
 	stotp.code = stotp.code / 30;
 	stotp.togo = 30;
 	stotp.run  = 1;
+	timer_job_start(TIMER_JOB_TOTP, tick_totp, 1, TIMER_JOB_PERIODIC);
 }
 
 void tick_totp() {
@@ -93,7 +96,7 @@ void display_totp(u8 line, u8 update) {
 			// and the lower 3 digits of TOTP code
 			switch(stotp.dispseq) {
 			case 0: clear_line(LINE2);
-			display_chars(LCD_SEG_L2_3_0, (u8 *) "TOTP", SEG_ON);
+			display_bitmap(&lcd_bmp_totp, SEG_ON);
 			break;
 			case 1: clear_line(LINE2);
 			str = int_to_array((n / 1000) % 1000, 3, 0);
@@ -106,7 +109,7 @@ void display_totp(u8 line, u8 update) {
 			}
 			stotp.dispseq = (stotp.dispseq + 1) % 3;
 		} else {
-			display_chars(LCD_SEG_L2_3_0, (u8 *) "TOTP", SEG_ON);
+			display_bitmap(&lcd_bmp_totp, SEG_ON);
 		}
 	} else if ((line == LINE2) && (update == DISPLAY_LINE_CLEAR)) {
 		reset_totp();
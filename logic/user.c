@@ -55,16 +55,17 @@
 
 // *************************************************************************************************
 // Prototypes section
+void set_value_fast_mode(s32 * value);
 
 // *************************************************************************************************
 // Defines section
 
 // *************************************************************************************************
 // Global Variable section
+struct setvalue sSetValue;
 
 // *************************************************************************************************
 // Extern section
-extern void idle_loop(void);
 
 // *************************************************************************************************
 // @fn          dummy
@@ -78,8 +79,11 @@ void dummy(u8 line)
 
 // *************************************************************************************************
 // @fn          set_value
-// @brief       Generic value setting routine
-// @param       s32 * value                                                     Pointer to value to
+// @brief       Generic value setting routine. Protothread, run by the flow of the calling menu
+//                              with PT_SPAWN(pt, &sSetValue.pt, set_value(&sSetValue.pt, ...)).
+//                              Arguments must be the same on every call.
+// @param       struct pt *pt                                           Protothread state
+//                              s32 * value                                                     Pointer to value to
 // set
 //                              u8digits
 //                                                        Number of digits
@@ -95,43 +99,41 @@ void dummy(u8 line)
 //                                                     Segments where value should be drawn
 //                              fptr_setValue_display_function1         Value-specific display
 // routine
-// @return      none
+// @return      u8                                                      PT_WAITING, PT_ENDED
 // *************************************************************************************************
-void set_value(s32 * value, u8 digits, u8 blanks, s32 limitLow, s32 limitHigh, u16 mode,
-               u8 segments,
-               void (*fptr_setValue_display_function1)(u8 segments, u32 value, u8 digits,
-                                                       u8 blanks))
+PT_THREAD(set_value(struct pt *pt, s32 * value, u8 digits, u8 blanks, s32 limitLow, s32 limitHigh,
+                    u16 mode, u8 segments,
+                    void (*fptr_setValue_display_function1)(u8 segments, u32 value, u8 digits,
+                                                            u8 blanks)))
 {
-    u8 update;
-    s16 stepValue = 1;
-    u8 doRound = 0;
-    u8 stopwatch_state;
     u32 val;
 
+    PT_BEGIN(pt);
+
     // Clear button flags
     button.all_flags = 0;
 
     // Clear blink memory
     clear_blink_mem();
 
-    // For safety only - buzzer on/off and button_repeat share same IRQ
-    stop_buzzer();
-
     // Disable stopwatch display update while function is active
-    stopwatch_state = sStopwatch.state;
+    sSetValue.stopwatch_state = sStopwatch.state;
     sStopwatch.state = STOPWATCH_HIDE;
 
     // Init step size and repeat counter
+    sSetValue.step = 1;
+    sSetValue.round = 0;
     sButton.repeats = 0;
 
     // Initial display update
-    update = 1;
+    sSetValue.update = 1;
 
     // Turn on 200ms button repeat function
     button_repeat_on(200);
 
     // Start blinking with with 2Hz
     set_blink_rate(BIT6 + BIT5);
+    start_blink();
 
     // Value set loop
     while (1)
@@ -155,7 +157,7 @@ void set_value(s32 * value, u8 digits, u8 blanks, s32 limitLow, s32 limitHigh, u
         if (button.flag.up)
         {
             // Increase value
-            *value = *value + stepValue;
+            *value = *value + sSetValue.step;
 
             // Check value limits
             if (*value > limitHigh)
@@ -167,11 +169,11 @@ void set_value(s32 * value, u8 digits, u8 blanks, s32 limitLow, s32 limitHigh, u
                     *value = limitHigh;
 
                 // Reset step size to default
-                stepValue = 1;
+                sSetValue.step = 1;
             }
 
             // Trigger display update
-            update = 1;
+            sSetValue.update = 1;
 
             // Clear button flag
             button.flag.up = 0;
@@ -181,7 +183,7 @@ void set_value(s32 * value, u8 digits, u8 blanks, s32 limitLow, s32 limitHigh, u
         if (button.flag.down)
         {
             // Decrease value
-            *value = *value - stepValue;
+            *value = *value - sSetValue.step;
 
             // Check value limits
             if (*value < limitLow)
@@ -193,11 +195,11 @@ void set_value(s32 * value, u8 digits, u8 blanks, s32 limitLow, s32 limitHigh, u
                     *value = limitLow;
 
                 // Reset step size to default
-                stepValue = 1;
+                sSetValue.step = 1;
             }
 
             // Trigger display update
-            update = 1;
+            sSetValue.update = 1;
 
             // Clear button flag
             button.flag.down = 0;
@@ -205,40 +207,10 @@ void set_value(s32 * value, u8 digits, u8 blanks, s32 limitLow, s32 limitHigh, u
 
         // When fast mode is enabled, increase step size if Sx button is continuously
         if ((mode & SETVALUE_FAST_MODE) == SETVALUE_FAST_MODE)
-        {
-            switch (sButton.repeats)
-            {
-                case 0:
-                    stepValue = 1;
-                    doRound = 0;
-                    break;
-                case 10:
-                case -10:
-                    stepValue = 10;
-                    doRound = 1;
-                    break;
-                case 20:
-                case -20:
-                    stepValue = 100;
-                    doRound = 1;
-                    break;
-                case 30:
-                case -30:
-                    stepValue = 1000;
-                    doRound = 1;
-                    break;
-            }
-
-            // Round value to avoid odd numbers on display
-            if (stepValue != 1 && doRound == 1)
-            {
-                *value -= *value % stepValue;
-                doRound = 0;
-            }
-        }
+            set_value_fast_mode(value);
 
         // Update display when there is new data
-        if (update)
+        if (sSetValue.update)
         {
             // Display up or down arrow according to sign of value
             if ((mode & SETVALUE_DISPLAY_ARROWS) == SETVALUE_DISPLAY_ARROWS)
@@ -266,12 +238,11 @@ void set_value(s32 * value, u8 digits, u8 blanks, s32 limitLow, s32 limitHigh, u
             fptr_setValue_display_function1(segments, val, digits, blanks);
 
             // Clear update flag
-            update = 0;
+            sSetValue.update = 0;
         }
 
-        // Call idle loop to serve background tasks
-        idle_loop();
-
+        // Let background tasks run and wait for next event in LPM3
+        PT_SLEEP(pt);
     }
 
     // Clear up and down arrows
@@ -286,6 +257,46 @@ void set_value(s32 * value, u8 digits, u8 blanks, s32 limitLow, s32 limitHigh, u
     button_repeat_off();
 
     // Enable stopwatch display updates again
-    sStopwatch.state = stopwatch_state;
+    sStopwatch.state = sSetValue.stopwatch_state;
+
+    PT_END(pt);
 }
 
+// *************************************************************************************************
+// @fn          set_value_fast_mode
+// @brief       Increase step size of set_value() while UP / DOWN is held.
+// @param       s32 * value     Value to set, rounded to new step size
+// @return      none
+// *************************************************************************************************
+void set_value_fast_mode(s32 * value)
+{
+    switch (sButton.repeats)
+    {
+        case 0:
+            sSetValue.step = 1;
+            sSetValue.round = 0;
+            break;
+        case 10:
+        case -10:
+            sSetValue.step = 10;
+            sSetValue.round = 1;
+            break;
+        case 20:
+        case -20:
+            sSetValue.step = 100;
+            sSetValue.round = 1;
+            break;
+        case 30:
+        case -30:
+            sSetValue.step = 1000;
+            sSetValue.round = 1;
+            break;
+    }
+
+    // Round value to avoid odd numbers on display
+    if (sSetValue.step != 1 && sSetValue.round == 1)
+    {
+        *value -= *value % sSetValue.step;
+        sSetValue.round = 0;
+    }
+}
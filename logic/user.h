@@ -36,6 +36,10 @@
 #ifndef USER_H_
 #define USER_H_
 
+// *************************************************************************************************
+// Include section
+#include "pt.h"
+
 // *************************************************************************************************
 // Defines section
 #define SETVALUE_ROLLOVER_VALUE                         BIT0
@@ -45,15 +49,33 @@
 #define SETVALUE_FAST_MODE                                      BIT4
 #define SETVALUE_NEXT_VALUE                                     BIT5
 
+// State of set_value() between calls
+struct setvalue
+{
+    // Protothread state, spawned by the calling flow
+    struct pt pt;
+
+    // Current step size, 1 = round value to new step size
+    s16 step;
+    u8 round;
+
+    // 1 = value needs to be redrawn
+    u8 update;
+
+    // Stopwatch state to restore when done
+    u8 stopwatch_state;
+};
+extern struct setvalue sSetValue;
+
 // *************************************************************************************************
 // Prototypes section
 extern u8 *select_view_style(u8 line, u8 * view1, u8 * view2);
 
 extern void (*fptr_setValue_display_function1)(u8 segments, u32 value, u8 digits, u8 blanks);
-extern void set_value(s32 * value, u8 digits, u8 blanks, s32 limitLow, s32 limitHigh, u16 mode,
-                      u8 segments,
-                      void (*fptr_setValue_display_function1)(u8 segments, u32 value, u8 digits,
-                                                              u8 blanks));
+extern PT_THREAD(set_value(struct pt *pt, s32 * value, u8 digits, u8 blanks, s32 limitLow,
+                           s32 limitHigh, u16 mode, u8 segments,
+                           void (*fptr_setValue_display_function1)(u8 segments, u32 value,
+                                                                   u8 digits, u8 blanks)));
 extern void dummy(u8 line);
 
 #endif                          /*USER_H_ */
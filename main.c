@@ -94,7 +94,12 @@
 #include "buzzer.h"
 #include "ports.h"
 #include "timer.h"
+#include "rtc.h"
+#include "event.h"
+#include "task.h"
 #include "pmm.h"
+#include "power.h"
+#include "stack.h"
 #include "rf1a.h"
 
 // logic
@@ -113,17 +118,26 @@
 #include "test.h"
 #include "totp.h"
 #include "counter.h"
+#include "profile.h"
+#include "logger.h"
 
 // *************************************************************************************************
 // Prototypes section
 void init_application(void);
 void init_global_variables(void);
 void wakeup_event(void);
-void process_requests(void);
+PT_THREAD(task_requests(struct pt *pt));
 void display_update(void);
 void idle_loop(void);
 void configure_ports(void);
 void read_calibration_values(void);
+void tick_message(void);
+void tick_idle_timeout(void);
+void process_acceleration_measurement(u8 param);
+void process_voltage_measurement(u8 param);
+void process_buzzer(u8 param);
+void process_counter_measurement(u8 param);
+void process_logger(u8 param);
 
 // *************************************************************************************************
 // Defines section
@@ -137,9 +151,6 @@ void read_calibration_values(void);
 // Variable holding system internal flags
 volatile s_system_flags sys;
 
-// Variable holding flags set by logic modules
-volatile s_request_flags request;
-
 // Variable holding message flags
 volatile s_message_flags message;
 
@@ -154,6 +165,18 @@ u8 rf_frequoffset;
 void (*fptr_lcd_function_line1)(u8 line, u8 update);
 void (*fptr_lcd_function_line2)(u8 line, u8 update);
 
+// Event handlers, called by task_requests() with event parameter. Index is event type.
+void (*const event_handler[EVENT_TYPES])(u8 param) = {
+    temperature_measurement,            // EVENT_TEMPERATURE_MEASUREMENT
+    process_voltage_measurement,        // EVENT_VOLTAGE_MEASUREMENT
+    do_altitude_measurement,            // EVENT_ALTITUDE_MEASUREMENT
+    process_acceleration_measurement,   // EVENT_ACCELERATION_MEASUREMENT
+    process_buzzer,                     // EVENT_BUZZER
+    process_counter_measurement,        // EVENT_COUNTER_MEASUREMENT
+    process_logger,                     // EVENT_LOGGER
+    sample_altitude_session,            // EVENT_ALTITUDE_SESSION
+};
+
 // *************************************************************************************************
 // Extern section
 
@@ -170,6 +193,9 @@ int main(void)
     // Init MCU
     init_application();
 
+    // Fill unused RAM with pattern to find stack high-water mark later
+    stack_paint();
+
     // Assign initial value to global variables
     init_global_variables();
 
@@ -179,17 +205,17 @@ int main(void)
     // Main control loop: wait in low power mode until some event needs to be processed
     while (1)
     {
-        // When idle go to LPM3
+        // Serve background tasks, then go to LPM3 when idle
         idle_loop();
 
+        // A foreground flow (menu setting, RF session) handles buttons and display itself
+        if (is_task_flow())
+            continue;
+
         // Process wake-up events
         if (button.all_flags || sys.all_flags)
             wakeup_event();
 
-        // Process actions requested by logic modules
-        if (request.all_flags)
-            process_requests();
-
         // Before going to LPM3, update display
         if (display.all_flags)
             display_update();
@@ -307,8 +333,12 @@ void init_application(void)
     init_buttons();
 
     // ---------------------------------------------------------------------
-    // Configure Timer0 for use by the clock and delay functions
+    // Configure Timer0 for use by the delay functions
     Timer0_Init();
+
+    // ---------------------------------------------------------------------
+    // Configure RTC_A for use by the clock
+    rtc_init();
     // ---------------------------------------------------------------------
 
     // ---------------------------------------------------------------------
@@ -360,10 +390,13 @@ void init_global_variables(void)
     // Init system flags
     button.all_flags = 0;
     sys.all_flags = 0;
-    request.all_flags = 0;
     display.all_flags = 0;
     message.all_flags = 0;
 
+    // Init request queue and background tasks
+    event_init();
+    task_init();
+
     // Force full display update when starting up
     display.flag.full_update = 1;
 
@@ -378,6 +411,9 @@ void init_global_variables(void)
     // reset counter
      reset_counter();
 
+    // Start power accounting
+    reset_power();
+
     // Set system time to default value
     reset_clock();
 
@@ -399,9 +435,17 @@ void init_global_variables(void)
     // Reset acceleration measurement
     reset_acceleration();
 
+#ifdef USE_PROFILING
+    // Clear run time statistics
+    reset_profile();
+#endif
+
     // Reset SimpliciTI stack
     reset_rf();
 
+    // Find end of data log
+    reset_logger();
+
     // Reset temperature measurement
     reset_temp_measurement();
 
@@ -420,6 +464,7 @@ void wakeup_event(void)
 {
     // Enable idle timeout
     sys.flag.idle_timeout_enabled = 1;
+    timer_job_start(TIMER_JOB_IDLE_TIMEOUT, tick_idle_timeout, 1, TIMER_JOB_PERIODIC);
 
     // If buttons are locked, only display "buttons are locked" message
     if (button.all_flags && sys.flag.lock_buttons)
@@ -429,6 +474,7 @@ void wakeup_event(void)
         {
             message.flag.prepare = 1;
             message.flag.type_locked = 1;
+            timer_job_start(TIMER_JOB_MESSAGE, tick_message, 1, TIMER_JOB_PERIODIC);
         }
         // Clear buttons
         button.all_flags = 0;
@@ -531,6 +577,13 @@ void wakeup_event(void)
             // Clear button flag
             button.flag.down = 0;
         }
+        // Double button press events -----------------------------------------------------------
+        // No menu action assigned, second press was already processed as short button press
+        else
+        {
+            button.flag.star_double = 0;
+            button.flag.num_double = 0;
+        }
     }
     // Process internal events
     if (sys.all_flags)
@@ -550,41 +603,128 @@ void wakeup_event(void)
     }
     // Disable idle timeout
     sys.flag.idle_timeout_enabled = 0;
+    timer_job_stop(TIMER_JOB_IDLE_TIMEOUT);
+}
+
+// *************************************************************************************************
+// @fn          tick_idle_timeout
+// @brief       Timer job while idle timeout is enabled. Sets timeout flag after inactivity.
+// @param       none
+// @return      none
+// *************************************************************************************************
+void tick_idle_timeout(void)
+{
+    if (sTime.system_time - sTime.last_activity > INACTIVITY_TIME)
+        sys.flag.idle_timeout = 1;
 }
 
 // *************************************************************************************************
-// @fn          process_requests
-// @brief       Process requested actions outside ISR context.
+// @fn          tick_message
+// @brief       Timer job while a message is pending. Shows prepared message with clock tick and
+//                              erases it with next clock tick.
 // @param       none
 // @return      none
 // *************************************************************************************************
-void process_requests(void)
+void tick_message(void)
 {
-    // Do temperature measurement
-    if (request.flag.temperature_measurement)
-        temperature_measurement(FILTER_ON);
+    if (message.flag.prepare)
+    {
+        message.flag.prepare = 0;
+        message.flag.show = 1;
+    }
+    else if (message.flag.erase)        // message cycle is over, so erase it
+    {
+        message.flag.erase = 0;
+        display.flag.full_update = 1;
+    }
 
-    // Do pressure measurement
-    if (request.flag.altitude_measurement)
-        do_altitude_measurement(FILTER_ON);
+    // Message cycle is over
+    if (message.all_flags == 0)
+        timer_job_stop(TIMER_JOB_MESSAGE);
+}
 
-    // Do acceleration measurement
-    if (request.flag.acceleration_measurement)
-        do_acceleration_measurement();
+// *************************************************************************************************
+// @fn          task_requests
+// @brief       Background task. Process requested actions outside ISR context, one per call.
+// @param       struct pt *pt   Protothread state
+// @return      u8              PT_WAITING, PT_YIELDED
+// *************************************************************************************************
+PT_THREAD(task_requests(struct pt *pt))
+{
+    static struct event ev;
 
-    // Do voltage measurement
-    if (request.flag.voltage_measurement)
-        battery_measurement();
+    PT_BEGIN(pt);
 
-    // Generate alarm (two signals every second)
-    if (request.flag.buzzer)
-        start_buzzer(2, BUZZER_ON_TICKS, BUZZER_OFF_TICKS);
+    while (1)
+    {
+        PT_WAIT_UNTIL(pt, event_get(&ev));
 
-    if (request.flag.counter_measurement)
-    	do_counter_measurement();
+        {
+            PROFILE_ENTER();
+            event_handler[ev.type](ev.param);
+            PROFILE_EXIT(PROFILE_REQUESTS);
+        }
+
+        // Let other tasks run before next request
+        PT_YIELD(pt);
+    }
 
-    // Reset request flag
-    request.all_flags = 0;
+    PT_END(pt);
+}
+
+// *************************************************************************************************
+// @fn          process_acceleration_measurement
+// @brief       Event handler for EVENT_ACCELERATION_MEASUREMENT.
+// @param       u8 param        Not used
+// @return      none
+// *************************************************************************************************
+void process_acceleration_measurement(u8 param)
+{
+    do_acceleration_measurement();
+}
+
+// *************************************************************************************************
+// @fn          process_voltage_measurement
+// @brief       Event handler for EVENT_VOLTAGE_MEASUREMENT.
+// @param       u8 param        Not used
+// @return      none
+// *************************************************************************************************
+void process_voltage_measurement(u8 param)
+{
+    battery_measurement();
+}
+
+// *************************************************************************************************
+// @fn          process_buzzer
+// @brief       Event handler for EVENT_BUZZER. Generates alarm signal.
+// @param       u8 param        Number of buzzer signals
+// @return      none
+// *************************************************************************************************
+void process_buzzer(u8 param)
+{
+    start_buzzer(param, BUZZER_ON_TICKS, BUZZER_OFF_TICKS);
+}
+
+// *************************************************************************************************
+// @fn          process_counter_measurement
+// @brief       Event handler for EVENT_COUNTER_MEASUREMENT.
+// @param       u8 param        Not used
+// @return      none
+// *************************************************************************************************
+void process_counter_measurement(u8 param)
+{
+    do_counter_measurement();
+}
+
+// *************************************************************************************************
+// @fn          process_logger
+// @brief       Event handler for EVENT_LOGGER.
+// @param       u8 param        Passed to logger_tick()
+// @return      none
+// *************************************************************************************************
+void process_logger(u8 param)
+{
+    logger_tick(param);
 }
 
 // *************************************************************************************************
@@ -597,6 +737,8 @@ void display_update(void)
 {
     u8 line;
     u8 string[8];
+    const struct lcd_bitmap *bitmap = NULL;
+    PROFILE_ENTER();
 
     // ---------------------------------------------------------------------
     // Call Line1 display function
@@ -622,7 +764,7 @@ void display_update(void)
         else if (message.flag.type_unlocked)
             memcpy(string, "  OPEN", 6);
         else if (message.flag.type_lobatt)
-            memcpy(string, "LOBATT", 6);
+            bitmap = &lcd_bmp_lobatt;
         else if (message.flag.type_alarm_on)
         {
             memcpy(string, "  ON", 4);
@@ -636,7 +778,9 @@ void display_update(void)
         clear_line(line);
         fptr_lcd_function_line2(line, DISPLAY_LINE_CLEAR);
 
-        if (line == LINE2)
+        if (bitmap != NULL)
+            display_bitmap(bitmap, SEG_ON);
+        else if (line == LINE2)
             display_chars(LCD_SEG_L2_5_0, string, SEG_ON);
         else
             display_chars(LCD_SEG_L1_3_0, string, SEG_ON);
@@ -659,6 +803,8 @@ void display_update(void)
 
     // Clear display flag
     display.all_flags = 0;
+
+    PROFILE_EXIT(PROFILE_DISPLAY);
 }
 
 // *************************************************************************************************
@@ -669,19 +815,38 @@ void display_update(void)
 // *************************************************************************************************
 void to_lpm(void)
 {
+    // Write pending display changes to LCD controller
+    lcd_commit();
+
     // Go to LPM3
+    power_sleep();
     _BIS_SR(LPM3_bits + GIE);
     __no_operation();
+    power_wakeup();
 }
 
 // *************************************************************************************************
 // @fn          idle_loop
-// @brief       Go to LPM. Service watchdog timer when waking up.
+// @brief       Serve background tasks, then go to LPM. Service watchdog timer when waking up.
 // @param       none
 // @return      none
 // *************************************************************************************************
 void idle_loop(void)
 {
+    // Serve background tasks - stay awake while a task has more work
+    sTask.wakeup = 0;
+    if (task_run(TASK_ALL))
+        return;
+
+    // An ISR may have ended a task wait after the task checked it - stay awake then, else the
+    // task would wait until the next interrupt. to_lpm() sets GIE together with LPM3.
+    __disable_interrupt();
+    if (sTask.wakeup)
+    {
+        __enable_interrupt();
+        return;
+    }
+
     // To low power mode
     to_lpm();
 
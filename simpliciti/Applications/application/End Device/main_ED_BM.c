@@ -28,12 +28,14 @@
 
 // *************************************************************************************************
 // Include section
+#include <string.h>
 #include "bsp.h"
 #include "mrfi.h"
 #include "nwk_types.h"
 #include "nwk_api.h"
 #include "bsp_leds.h"
 #include "bsp_buttons.h"
+#include "nwk_globals.h"
 #include "simpliciti.h"
 
 
@@ -44,11 +46,50 @@
 // Conversion from msec to ACLK timer ticks
 #define CONV_MS_TO_TICKS(msec)                          (((msec) * 32768) / 1000)
 
-// U16
+// Time to listen for host reply after ready-to-receive packet (ms)
+#define SYNC_RX_TIMEOUT                         (10u)
+
+// Adaptive output power in sync mode: host frames received above TXPWR_RSSI_HIGH for
+// TXPWR_GOOD_FRAMES frames in a row allow one power step down, a host frame below
+// TXPWR_RSSI_LOW or a lost reply steps back up to full power at once
+#define TXPWR_RSSI_HIGH                         (-50)
+#define TXPWR_RSSI_LOW                          (-80)
+#define TXPWR_GOOD_FRAMES                       (8u)
+
+// Wake-on-radio interval limits (ms)
+#define SYNC_LISTEN_MIN                         (50u)
+#define SYNC_LISTEN_MAX                         (10000u)
+
+// Link credentials are cached in info flash segment C (segment D holds calibration data)
+#define LINK_CACHE                              ((const struct link_cache *) 0x1880)
+#define LINK_CACHE_VALID                        (0xA5u)
+
+// U8, U16
+typedef unsigned char u8;
 typedef unsigned short u16;
 
+// Protothreads, need u8 and u16
+#include "pt.h"
+
+// Link credentials returned by last successful join
+struct link_cache
+{
+    uint32_t link_token;
+    addr_t ap_address;
+    uint8_t valid;
+};
+
 // *************************************************************************************************
 // Prototypes section
+static uint8_t link_cache_resume(void);
+static void link_cache_save(void);
+static uint8_t rx_callback(linkID_t lid);
+static void rx_wait(uint16_t ms);
+static void sync_exchange(void);
+static void sync_listen_start(uint16_t interval);
+static void sync_listen_stop(void);
+static void txpwr_set(ioctlLevel_t level);
+static void txpwr_update(uint8_t lost);
 
 
 // *************************************************************************************************
@@ -57,28 +98,49 @@ extern uint8_t sInit_done;
 
 // SimpliciTI has no low power delay function, so we have to use ours
 extern void Timer0_A4_Delay(u16 ticks);
+extern void Timer0_A4_Stop(void);
+
+// Wake up protothread waiting for a host frame
+extern void Timer0_A1_Stop(void);
+
+// Flash driver
+extern void flash_erase(u8 * ptr);
+extern void flash_write(u8 * ptr, const u8 * data, u16 length);
 
 
 // *************************************************************************************************
 // Global Variable section
 static linkID_t sLinkID1;
 
+// 1 = frame received since last sync_listen_start() or SMPL_Receive() try
+static volatile uint8_t sRxFrame;
+
+// 1 = waiting for a host frame - a received frame ends the delay
+static volatile uint8_t sRxWait;
+
+// Current output power level and number of strong host frames received at this level
+static ioctlLevel_t sTxPwr;
+static uint8_t sTxPwrGood;
+
 
 
 // *************************************************************************************************
 // @fn          simpliciti_link
-// @brief       Init hardware and try to link to access point.
-// @param       none
-// @return      unsigned char		0 = Could not link, timeout or external cancel.
-//									1 = Linked successful.
+// @brief       Init hardware and try to link to access point. Retries wait in LPM3, other tasks
+//				run meanwhile. Result is SIMPLICITI_STATUS_LINKED or SIMPLICITI_STATUS_ERROR
+//				in simpliciti_flag (no status change on external cancel).
+// @param       struct pt *pt		Protothread state
+// @return      unsigned char		PT_WAITING, PT_ENDED
 // *************************************************************************************************
-unsigned char simpliciti_link(void)
+PT_THREAD(simpliciti_link(struct pt *pt))
 {
-    uint8_t timeout;
+    static uint8_t timeout;
     addr_t lAddr;
     uint8_t i;
     uint8_t pwr;
 
+    PT_BEGIN(pt);
+
     // Configure timer
     BSP_InitBoard();
 
@@ -92,18 +154,20 @@ unsigned char simpliciti_link(void)
     // Set flag
     simpliciti_flag = SIMPLICITI_STATUS_LINKING;
 
+    // Skip join and try a single link with credentials of last session
+    if (link_cache_resume())
+    {
+        simpliciti_flag = SIMPLICITI_STATUS_LINKED;
+        PT_EXIT(pt);
+    }
+
     /* Keep trying to join (a side effect of successful initialization) until
      * successful. Toggle LEDS to indicate that joining has not occurred.
      */
     timeout = 0;
-    while (SMPL_SUCCESS != SMPL_Init(0))
+    while (SMPL_SUCCESS != SMPL_Init(rx_callback))
     {
-        NWK_DELAY(1000);
-
-#ifdef USE_WATCHDOG
-        // Service watchdog
-        WDTCTL = WDTPW + WDTIS__512K + WDTSSEL__ACLK + WDTCNTCL;
-#endif
+        PT_DELAY(pt, CONV_MS_TO_TICKS(1000));
 
         // Stop connecting after defined numbers of seconds (15)
         if (timeout++ > TIMEOUT)
@@ -111,7 +175,7 @@ unsigned char simpliciti_link(void)
             // Clean up SimpliciTI stack to enable restarting
             sInit_done = 0;
             simpliciti_flag = SIMPLICITI_STATUS_ERROR;
-            return (0);
+            PT_EXIT(pt);
         }
 
         // Break when flag bit SIMPLICITI_TRIGGER_STOP is set
@@ -119,7 +183,7 @@ unsigned char simpliciti_link(void)
         {
             // Clean up SimpliciTI stack to enable restarting
             sInit_done = 0;
-            return (0);
+            PT_EXIT(pt);
         }
     }
 
@@ -131,12 +195,7 @@ unsigned char simpliciti_link(void)
     timeout = 0;
     while (SMPL_SUCCESS != SMPL_Link(&sLinkID1))
     {
-        NWK_DELAY(1000);
-
-#ifdef USE_WATCHDOG
-        // Service watchdog
-        WDTCTL = WDTPW + WDTIS__512K + WDTSSEL__ACLK + WDTCNTCL;
-#endif
+        PT_DELAY(pt, CONV_MS_TO_TICKS(1000));
 
         // Stop linking after timeout
         if (timeout++ > TIMEOUT)
@@ -144,7 +203,7 @@ unsigned char simpliciti_link(void)
             // Clean up SimpliciTI stack to enable restarting
             sInit_done = 0;
             simpliciti_flag = SIMPLICITI_STATUS_ERROR;
-            return (0);
+            PT_EXIT(pt);
         }
 
         // Exit when flag bit SIMPLICITI_TRIGGER_STOP is set
@@ -152,26 +211,97 @@ unsigned char simpliciti_link(void)
         {
             // Clean up SimpliciTI stack to enable restarting
             sInit_done = 0;
-            return (0);
+            PT_EXIT(pt);
         }
     }
+
+    // Keep credentials for fast reconnect next time
+    link_cache_save();
+
     simpliciti_flag = SIMPLICITI_STATUS_LINKED;
 
-    return (1);
+    PT_END(pt);
 }
 
 // *************************************************************************************************
-// @fn          simpliciti_main_tx_only
-// @brief       Get data through callback. Transfer data when external trigger is set.
+// @fn          link_cache_resume
+// @brief       Init stack with cached link token and access point address instead of a join and
+//                              send a single link request. Access point only replies when it still
+//                              accepts the link token.
+// @param       none
+// @return      uint8_t         0 = No valid cache or no link reply, full join required.
+//                                                      1 = Linked successful.
+// *************************************************************************************************
+static uint8_t link_cache_resume(void)
+{
+    const struct link_cache *cache = LINK_CACHE;
+    ioctlToken_t token;
+    addr_t ap_address;
+    uint8_t pwr;
+
+    if (cache->valid != LINK_CACHE_VALID)
+        return (0);
+
+    // Link token must be set before stack init
+    token.tokenType = TT_LINK;
+    token.token.linkToken = cache->link_token;
+    SMPL_Ioctl(IOCTL_OBJ_TOKEN, IOCTL_ACT_SET, &token);
+
+    ap_address = cache->ap_address;
+    if (SMPL_InitResume(rx_callback, &ap_address) != SMPL_SUCCESS)
+        return (0);
+
+    // Set output power to +3.3dmB
+    pwr = IOCTL_LEVEL_2;
+    SMPL_Ioctl(IOCTL_OBJ_RADIO, IOCTL_ACT_RADIO_SETPWR, &pwr);
+
+    return (SMPL_Link(&sLinkID1) == SMPL_SUCCESS);
+}
+
+// *************************************************************************************************
+// @fn          link_cache_save
+// @brief       Store link token and access point address of successful join in info flash.
+//                              Flash is only written when credentials have changed.
 // @param       none
 // @return      none
 // *************************************************************************************************
-void simpliciti_main_tx_only(void)
+static void link_cache_save(void)
+{
+    struct link_cache cache;
+    ioctlToken_t token;
+
+    // Clear padding for compare
+    memset(&cache, 0, sizeof(cache));
+
+    token.tokenType = TT_LINK;
+    SMPL_Ioctl(IOCTL_OBJ_TOKEN, IOCTL_ACT_GET, &token);
+    cache.link_token = token.token.linkToken;
+    memcpy(&cache.ap_address, nwk_getAPAddress(), sizeof(addr_t));
+    cache.valid = LINK_CACHE_VALID;
+
+    if (memcmp(&cache, LINK_CACHE, sizeof(cache)) != 0)
+    {
+        flash_erase((u8 *) LINK_CACHE);
+        flash_write((u8 *) LINK_CACHE, (const u8 *) &cache, sizeof(cache));
+    }
+}
+
+// *************************************************************************************************
+// @fn          simpliciti_main_tx_only
+// @brief       Get data from application. Transfer data when external trigger is set.
+// @param       struct pt *pt		Protothread state
+// @return      unsigned char		PT_WAITING, PT_ENDED
+// *************************************************************************************************
+PT_THREAD(simpliciti_main_tx_only(struct pt *pt))
 {
+    static struct pt data_pt;
+
+    PT_BEGIN(pt);
+
     while (1)
     {
-        // Get end device data from callback function
-        simpliciti_get_ed_data_callback();
+        // Get end device data from application, waits for next sample or button event
+        PT_SPAWN(pt, &data_pt, simpliciti_get_ed_data(&data_pt));
 
         // Send data when flag bit SIMPLICITI_TRIGGER_SEND_DATA is set
         if (getFlag(simpliciti_flag, SIMPLICITI_TRIGGER_SEND_DATA))
@@ -179,8 +309,10 @@ void simpliciti_main_tx_only(void)
             // Get radio ready. Wakes up in IDLE state.
             SMPL_Ioctl(IOCTL_OBJ_RADIO, IOCTL_ACT_RADIO_AWAKE, 0);
 
-            // Acceleration / button events packets are 4 bytes long
-            SMPL_SendOpt(sLinkID1, simpliciti_data, 4, SMPL_TXOPTION_NONE);
+            // Acceleration / button events packets are 4 bytes long, batched acceleration
+            // packets up to 19 bytes
+            SMPL_SendOpt(sLinkID1, simpliciti_data, simpliciti_payload_length, SMPL_TXOPTION_NONE);
+            simpliciti_sent_ed_data_callback();
 
             // Put radio back to SLEEP state
             SMPL_Ioctl(IOCTL_OBJ_RADIO, IOCTL_ACT_RADIO_SLEEP, 0);
@@ -196,64 +328,84 @@ void simpliciti_main_tx_only(void)
             break;
         }
     }
+
+    PT_END(pt);
 }
 
 // *************************************************************************************************
-// @fn          simpliciti_main_sync
-// @brief       Send ready-to-receive packets in regular intervals. Listen shortly for host reply.
-//				Decode received host command and trigger action.
-// @param       none
-// @return      none
+// @fn          rx_callback
+// @brief       Called by SimpliciTI in radio ISR context when a frame for the link was received.
+//				Ends the wait for a host reply, so that radio can go back to sleep early,
+//				and wakes up simpliciti_main_sync() in wake-on-radio.
+//				Other delays (e.g. while sending) are not affected.
+// @param       linkID_t lid		Link of received frame
+// @return      uint8_t		0 = keep frame for SMPL_Receive
 // *************************************************************************************************
-void simpliciti_main_sync(void)
+static uint8_t rx_callback(linkID_t lid)
 {
-    uint8_t len, i;
-    uint8_t ed_data[2];
+    sRxFrame = 1;
+    if (sRxWait)
+        Timer0_A4_Stop();
+    Timer0_A1_Stop();
+    return (0);
+}
 
-    while (1)
+// *************************************************************************************************
+// @fn          rx_wait
+// @brief       Wait for a host frame in LPM3. Received frame ends the wait early. Does not wait
+//				when a frame has arrived since the last SMPL_Receive() try.
+// @param       uint16_t ms		Maximum wait time (ms)
+// @return      none
+// *************************************************************************************************
+static void rx_wait(uint16_t ms)
+{
+    // A frame received before the delay is set up could not end it - check with interrupts
+    // disabled, Timer0_A4_Delay() enables them together with LPM3
+    __disable_interrupt();
+    if (!sRxFrame)
     {
-        // Sleep 0.5sec between ready-to-receive packets
-        // SimpliciTI has no low power delay function, so we have to use ours
-        Timer0_A4_Delay(CONV_MS_TO_TICKS(500));
+        sRxWait = 1;
+        Timer0_A4_Delay(CONV_MS_TO_TICKS(ms));
+        sRxWait = 0;
+    }
+    __enable_interrupt();
+}
 
-        // Get radio ready. Radio wakes up in IDLE state.
-        SMPL_Ioctl(IOCTL_OBJ_RADIO, IOCTL_ACT_RADIO_AWAKE, 0);
+// *************************************************************************************************
+// @fn          simpliciti_main_sync
+// @brief       Send ready-to-receive packets in regular intervals. Listen shortly for host reply.
+//				Decode received host command and trigger action. Waits between packets are
+//				spent in LPM3, other tasks run meanwhile.
+// @param       struct pt *pt		Protothread state
+// @return      unsigned char		PT_WAITING, PT_ENDED
+// *************************************************************************************************
+PT_THREAD(simpliciti_main_sync(struct pt *pt))
+{
+    PT_BEGIN(pt);
 
-        // Send 2 byte long ready-to-receive packet to stimulate host reply
-        ed_data[0] = SYNC_ED_TYPE_R2R;
-        ed_data[1] = 0xCB;
-        SMPL_SendOpt(sLinkID1, ed_data, 2, SMPL_TXOPTION_NONE);
+    simpliciti_listen_interval = 0;
 
-        // Wait shortly for host reply
-        SMPL_Ioctl(IOCTL_OBJ_RADIO, IOCTL_ACT_RADIO_RXON, 0);
-        NWK_DELAY(10);
+    // Start at full power, reduce while host frames are strong
+    txpwr_set(IOCTL_LEVEL_2);
 
-        // Check if a command packet was received
-        while (SMPL_Receive(sLinkID1, simpliciti_data, &len) == SMPL_SUCCESS)
+    while (1)
+    {
+        if (simpliciti_listen_interval)
         {
-            // Decode received data
-            if (len > 0)
-            {
-                // Use callback function in application to decode data and react
-                simpliciti_sync_decode_ap_cmd_callback();
-
-                // Get reply data and send out reply packet burst (19 bytes each)
-                for (i = 0; i < simpliciti_reply_count; i++)
-                {
-                    NWK_DELAY(10);
-                    simpliciti_sync_get_data_callback(i);
-                    SMPL_SendOpt(sLinkID1, simpliciti_data, BM_SYNC_DATA_LENGTH, SMPL_TXOPTION_NONE);
-                }
-            }
+            // Host has sent us to wake-on-radio - send next ready-to-receive packet as soon as
+            // host wakes us up
+            sync_listen_start(simpliciti_listen_interval);
+            PT_WAIT_UNTIL(pt, sRxFrame || getFlag(simpliciti_flag, SIMPLICITI_TRIGGER_STOP));
+            sync_listen_stop();
+            simpliciti_listen_interval = 0;
+        }
+        else
+        {
+            // Sleep 0.5sec between ready-to-receive packets
+            PT_DELAY(pt, CONV_MS_TO_TICKS(500));
         }
 
-        // Put radio back to sleep
-        SMPL_Ioctl(IOCTL_OBJ_RADIO, IOCTL_ACT_RADIO_SLEEP, 0);
-
-#ifdef USE_WATCHDOG
-        // Service watchdog
-        WDTCTL = WDTPW + WDTIS__512K + WDTSSEL__ACLK + WDTCNTCL;
-#endif
+        sync_exchange();
 
         // Exit when flag bit SIMPLICITI_TRIGGER_STOP is set
         if (getFlag(simpliciti_flag, SIMPLICITI_TRIGGER_STOP))
@@ -263,5 +415,156 @@ void simpliciti_main_sync(void)
             break;
         }
     }
+
+    PT_END(pt);
+}
+
+// *************************************************************************************************
+// @fn          sync_exchange
+// @brief       Send ready-to-receive packet, then receive host commands and send replies until
+//				host is silent. Waits for host frames (max. SYNC_WINDOW_TIMEOUT) block in
+//				LPM3.
+// @param       none
+// @return      none
+// *************************************************************************************************
+static void sync_exchange(void)
+{
+    uint8_t len, i, wait, cmd, window;
+    uint8_t ed_data[2];
+
+    // Get radio ready. Radio wakes up in IDLE state.
+    SMPL_Ioctl(IOCTL_OBJ_RADIO, IOCTL_ACT_RADIO_AWAKE, 0);
+
+    // Send 2 byte long ready-to-receive packet to stimulate host reply
+    ed_data[0] = SYNC_ED_TYPE_R2R;
+    ed_data[1] = 0xCB;
+    SMPL_SendOpt(sLinkID1, ed_data, 2, SMPL_TXOPTION_NONE);
+
+    // Listen for host reply. After a windowed transfer keep listening, host replies with
+    // ACK bitmap or next command right away. Waiting in LPM3 ends when a frame is received.
+    SMPL_Ioctl(IOCTL_OBJ_RADIO, IOCTL_ACT_RADIO_RXON, 0);
+    wait = SYNC_RX_TIMEOUT;
+    window = 0;
+    while (1)
+    {
+        sRxFrame = 0;
+        if (SMPL_Receive(sLinkID1, simpliciti_data, &len) != SMPL_SUCCESS)
+        {
+            if (wait == 0)
+            {
+                // Host did not answer windowed transfer - packets or ACK were lost
+                if (window)
+                    txpwr_update(1);
+                break;
+            }
+            rx_wait(wait);
+            wait = 0;
+            continue;
+        }
+
+        // Decode received data
+        if (len > 0)
+        {
+            // Use callback function in application to decode data and react
+            cmd = simpliciti_data[0];
+            simpliciti_sync_decode_ap_cmd_callback();
+
+            // ACK that requests packets again means packets were lost
+            txpwr_update((cmd == SYNC_AP_CMD_ACK_MEMORY_WINDOW) && (simpliciti_reply_count > 0));
+
+            // Get reply data and send out reply packet burst (19 bytes each)
+            for (i = 0; i < simpliciti_reply_count; i++)
+            {
+                if (!simpliciti_reply_window)
+                    NWK_DELAY(10);
+                simpliciti_sync_get_data_callback(i);
+                SMPL_SendOpt(sLinkID1, simpliciti_data, BM_SYNC_DATA_LENGTH, SMPL_TXOPTION_NONE);
+            }
+
+            wait = simpliciti_reply_window ? SYNC_WINDOW_TIMEOUT : 0;
+            window = simpliciti_reply_window;
+        }
+    }
+
+    // Put radio back to sleep
+    SMPL_Ioctl(IOCTL_OBJ_RADIO, IOCTL_ACT_RADIO_SLEEP, 0);
+}
+
+// *************************************************************************************************
+// @fn          sync_listen_start
+// @brief       Put radio in wake-on-radio. Radio sniffs for a carrier on its own, a host frame
+//				sets sRxFrame.
+// @param       uint16_t interval		Wake-on-radio interval (ms)
+// @return      none
+// *************************************************************************************************
+static void sync_listen_start(uint16_t interval)
+{
+    if (interval < SYNC_LISTEN_MIN)
+        interval = SYNC_LISTEN_MIN;
+    if (interval > SYNC_LISTEN_MAX)
+        interval = SYNC_LISTEN_MAX;
+
+    sRxFrame = 0;
+    SMPL_Ioctl(IOCTL_OBJ_RADIO, IOCTL_ACT_RADIO_AWAKE, 0);
+    MRFI_WorOn(interval);
+}
+
+// *************************************************************************************************
+// @fn          sync_listen_stop
+// @brief       Leave wake-on-radio and put radio to sleep.
+// @param       none
+// @return      none
+// *************************************************************************************************
+static void sync_listen_stop(void)
+{
+    MRFI_WorOff();
+    SMPL_Ioctl(IOCTL_OBJ_RADIO, IOCTL_ACT_RADIO_SLEEP, 0);
 }
 
+// *************************************************************************************************
+// @fn          txpwr_set
+// @brief       Set output power level.
+// @param       ioctlLevel_t level		IOCTL_LEVEL_0 (lowest) to IOCTL_LEVEL_2 (+3.3dBm)
+// @return      none
+// *************************************************************************************************
+static void txpwr_set(ioctlLevel_t level)
+{
+    sTxPwr = level;
+    sTxPwrGood = 0;
+    SMPL_Ioctl(IOCTL_OBJ_RADIO, IOCTL_ACT_RADIO_SETPWR, &sTxPwr);
+}
+
+// *************************************************************************************************
+// @fn          txpwr_update
+// @brief       Adapt output power after a host frame was received or a reply was lost. Power
+//				goes down one step at a time while the host is strong, and back to full power
+//				at once when frames get weak or are lost.
+// @param       uint8_t lost		1 = Host has not received our packets
+// @return      none
+// *************************************************************************************************
+static void txpwr_update(uint8_t lost)
+{
+    ioctlRadioSiginfo_t sig;
+
+    sig.lid = sLinkID1;
+    if (lost || (SMPL_Ioctl(IOCTL_OBJ_RADIO, IOCTL_ACT_RADIO_SIGINFO, &sig) != SMPL_SUCCESS))
+    {
+        sig.sigInfo.rssi = TXPWR_RSSI_LOW - 1;
+    }
+
+    if (sig.sigInfo.rssi < TXPWR_RSSI_LOW)
+    {
+        if (sTxPwr != IOCTL_LEVEL_2)
+            txpwr_set(IOCTL_LEVEL_2);
+        sTxPwrGood = 0;
+    }
+    else if (sig.sigInfo.rssi > TXPWR_RSSI_HIGH)
+    {
+        if ((++sTxPwrGood >= TXPWR_GOOD_FRAMES) && (sTxPwr != IOCTL_LEVEL_0))
+            txpwr_set((ioctlLevel_t) (sTxPwr - 1));
+    }
+    else
+    {
+        sTxPwrGood = 0;
+    }
+}
@@ -170,6 +170,8 @@ void MRFI_EnableRxAddrFilter(void);
 void MRFI_DisableRxAddrFilter(void);
 void MRFI_Sleep(void);
 void MRFI_WakeUp(void);
+void MRFI_WorOn(uint16_t);
+void MRFI_WorOff(void);
 uint8_t MRFI_RandomByte(void);
 
 void MRFI_DelayMs(uint16_t);
@@ -109,6 +109,25 @@ BSP_STATIC_ASSERT(MRFI_ADDR_SIZE ==
  */
 #define MRFI_SETTING_MCSM1      0x3C
 
+/* Wake-on-radio configuration:
+ * - RC oscillator on, calibrated at each crystal start
+ * - Event1 timeout 48 RC periods (crystal start-up)
+ * - WOR_RES = 1, Event0 resolution 2^5 periods = 0.923 ms
+ * Reset value (RC oscillator off) is restored when WOR ends.
+ */
+#define MRFI_SETTING_WORCTRL        0x79
+#define MRFI_SETTING_WORCTRL_OFF    0xF8
+
+/* RX termination during WOR: stop when no carrier is sensed (RX_TIME_RSSI), stay in RX after
+ * RX timeout only when preamble quality or sync word is found (RX_TIME_QUAL).
+ * Reset value (no RX timeout) is restored when WOR ends.
+ */
+#define MRFI_SETTING_MCSM2_WOR      0x18
+#define MRFI_SETTING_MCSM2_OFF      0x07
+
+/* Shortest WOR RX timeout that is still used (usec): RSSI valid plus some preamble */
+#define MRFI_WOR_RX_MIN_USECS       2000
+
 /*
  *  Packet Length - Setting for maximum allowed packet length.
  *  The PKTLEN setting does not include the length field but maximum frame size does.
@@ -1181,6 +1200,81 @@ void MRFI_WakeUp(void)
     mrfiRadioState = MRFI_RADIO_STATE_IDLE;
 }
 
+/**************************************************************************************************
+ * @fn          MRFI_WorOn
+ *
+ * @brief       Start wake-on-radio. Radio sleeps and wakes up on its own every 'interval'
+ *              msec to sniff for a carrier, without CPU involvement. When a frame is
+ *              received, the radio stays in receive mode and the frame is delivered as in
+ *              MRFI_RxOn(). The sender has to keep transmitting for at least one interval.
+ *              Radio must be awake. End with MRFI_WorOff().
+ *
+ * @param       interval - sniff interval in msec (15 - 60000)
+ *
+ * @return      none
+ **************************************************************************************************
+ */
+
+void MRFI_WorOn(uint16_t interval)
+{
+    uint32_t rxTimeout;
+    uint16_t event0;
+    uint8_t rxTime = 0;
+
+    /* radio must be awake before we can move it to WOR */
+    MRFI_ASSERT(mrfiRadioState != MRFI_RADIO_STATE_OFF);
+
+    /* start from IDLE with empty FIFO */
+    MRFI_RxIdle();
+
+    /* Event0 timeout = 750 / f_xosc * 2^5 * EVENT0 (WOR_RES = 1) */
+    event0 = (uint16_t)(((uint32_t)interval * (MRFI_RADIO_OSC_FREQ / 1000)) / (750 * 32));
+
+    /* RX timeout = 1.8 % of Event0 timeout / 2^RX_TIME (WOR_RES = 1). Use the shortest
+     * timeout that still gives RSSI valid and preamble detection.
+     */
+    rxTimeout = (uint32_t)interval * 18;
+    while ((rxTime < 6) && ((rxTimeout >> 1) >= MRFI_WOR_RX_MIN_USECS))
+    {
+        rxTimeout >>= 1;
+        rxTime++;
+    }
+
+    MRFI_RADIO_REG_WRITE(WOREVT1, event0 >> 8);
+    MRFI_RADIO_REG_WRITE(WOREVT0, event0 & 0xFF);
+    MRFI_RADIO_REG_WRITE(WORCTRL, MRFI_SETTING_WORCTRL);
+    MRFI_RADIO_REG_WRITE(MCSM2, MRFI_SETTING_MCSM2_WOR | rxTime);
+
+    /* frames are received as in RX state */
+    mrfiRadioState = MRFI_RADIO_STATE_RX;
+    MRFI_CLEAR_SYNC_PIN_INT_FLAG();
+    MRFI_ENABLE_SYNC_PIN_INT();
+
+    /* restart WOR timer and enter automatic RX polling */
+    MRFI_STROBE(SWORRST);
+    MRFI_STROBE(SWOR);
+}
+
+/**************************************************************************************************
+ * @fn          MRFI_WorOff
+ *
+ * @brief       End wake-on-radio. Radio is in IDLE state afterwards.
+ *
+ * @param       none
+ *
+ * @return      none
+ **************************************************************************************************
+ */
+
+void MRFI_WorOff(void)
+{
+    /* SIDLE also ends the automatic RX polling */
+    MRFI_RxIdle();
+
+    MRFI_RADIO_REG_WRITE(MCSM2, MRFI_SETTING_MCSM2_OFF);
+    MRFI_RADIO_REG_WRITE(WORCTRL, MRFI_SETTING_WORCTRL_OFF);
+}
+
 /**************************************************************************************************
  * @fn          MRFI_RadioIsr
  *
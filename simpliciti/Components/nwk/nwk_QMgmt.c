@@ -55,6 +55,9 @@
  * CONSTANTS AND DEFINES
  */
 
+/* Age of input frames saturates here, so that stamp differences never wrap */
+#define Q_AGE_MAX   0x7F
+
 /******************************************************************************
  * TYPEDEFS
  */
@@ -71,6 +74,9 @@ static frameInfo_t  *sInFrameQ = NULL;
 
 static frameInfo_t sOutFrameQ[SIZE_OUTFRAME_Q];
 
+/* Stamp of next input frame */
+static volatile uint8_t sInStamp;
+
 /******************************************************************************
  * LOCAL FUNCTIONS
  */
@@ -101,17 +107,23 @@ void nwk_QInit(void)
     memset(sInFrameQ, 0, sizeof(sInFrameQ));
 #endif  // SIZE_INFRAME_Q > 0
     memset(sOutFrameQ, 0, sizeof(sOutFrameQ));
+    sInStamp = 0;
 }
 
 /******************************************************************************
  * @fn          nwk_QfindSlot
  *
- * @brief       Finds a slot to use to retrieve the frame from the radio. It
- *              uses a LRU cast-out scheme. It is possible that this routine
- *              finds no slot. This can happen if the queue is of size 1 or 2
- *              and the Rx interrupt occurs during a retrieval call from an
- *              application. There are meta-states for frames as the application
- *              looks for the oldest frame on the port being requested.
+ * @brief       Finds a slot to use to retrieve the frame from the radio.
+ *              Input frames are stamped with a free running arrival counter,
+ *              so age is (current stamp - frame stamp) and no other frame
+ *              needs to be renumbered when a frame is added or removed.
+ *
+ *              Drop policy: an available slot is used if there is one.
+ *              Otherwise the oldest input frame not being retrieved by the
+ *              application is cast out. If all frames are in transition (queue
+ *              of size 1 or 2 and Rx interrupt during a retrieval call) no
+ *              slot is found and the new frame is dropped. The output queue
+ *              has no cast-out.
  *
  *              This routine is running in interrupt context.
  *
@@ -126,128 +138,69 @@ void nwk_QInit(void)
 frameInfo_t *nwk_QfindSlot(uint8_t which)
 {
     frameInfo_t *pFI, *oldest = 0, *newFI = 0;
-    uint8_t i, num, newOrder = 0, orderTest;
+    uint8_t i, age, oldestAge = 0;
 
-    if (INQ == which)
+    if (OUTQ == which)
     {
-        pFI  = sInFrameQ;
-        num  = SIZE_INFRAME_Q;
-    }
-    else
-    {
-        pFI  = sOutFrameQ;
-        num  = SIZE_OUTFRAME_Q;
+        for (i = 0, pFI = sOutFrameQ; i < SIZE_OUTFRAME_Q; ++i, ++pFI)
+        {
+            if (FI_AVAILABLE == pFI->fi_usage)
+            {
+                return pFI;
+            }
+        }
+        return (frameInfo_t *)0;
     }
 
-    orderTest = num + 1;
-
-    for (i = 0; i < num; ++i, ++pFI)
+    for (i = 0, pFI = sInFrameQ; i < SIZE_INFRAME_Q; ++i, ++pFI)
     {
-        /* if frame is available it's a candidate. */
-        if (pFI->fi_usage != FI_AVAILABLE)
+        if (FI_AVAILABLE == pFI->fi_usage)
         {
-            if (INQ == which) /* TODO: do cast-out for Tx as well */
-            {
+            newFI = pFI;
+            continue;
+        }
 
-                /* need to know the number of occupied slots so we know the age value
-                 * for the unoccupied slot (if there is one).
-                 */
-                newOrder++;
+        /* keep frames that stay in the queue for long old when the stamp
+         * counter wraps around. Stamp is advanced below, so the frame is
+         * Q_AGE_MAX old afterwards and nwk_QfindOldest() still sees it as
+         * the oldest.
+         */
+        age = sInStamp - pFI->orderStamp;
+        if (age >= Q_AGE_MAX)
+        {
+            age = Q_AGE_MAX - 1;
+            pFI->orderStamp = sInStamp - (Q_AGE_MAX - 1);
+        }
 
-                /* make sure nwk_retrieveFrame() is not processing this frame */
-                if (FI_INUSE_TRANSITION == pFI->fi_usage)
-                {
-                    continue;
-                }
-                /* is this frame older than any we've seen? */
-                if (orderTest > pFI->orderStamp)
-                {
-                    /* yes. */
-                    oldest    = pFI;
-                    orderTest = pFI->orderStamp;
-                }
-            }
+        /* make sure nwk_retrieveFrame() is not processing this frame */
+        if (FI_INUSE_TRANSITION == pFI->fi_usage)
+        {
+            continue;
         }
-        else
+        /* is this frame older than any we've seen? */
+        if (age > oldestAge)
         {
-            if (OUTQ == which) /* TODO: do cast-out for Tx as well */
-            {
-                return pFI;
-            }
-            newFI = pFI;
+            oldest    = pFI;
+            oldestAge = age;
         }
     }
 
     /* did we find anything? */
     if (!newFI)
     {
-        /* queue was full. cast-out happens here...unless... */
+        /* queue was full. cast-out happens here...unless all frames are in
+         * transition.
+         */
         if (!oldest)
         {
-            /* This can happen if the queue is only of size 1 or 2 and all
-             * the frames are in transition when the Rx interrupt occurs.
-             */
             return (frameInfo_t *)0;
         }
         newFI = oldest;
-        nwk_QadjustOrder(which, newFI->orderStamp);
-        newFI->orderStamp = i;
-    }
-    else
-    {
-        /* mark the available slot. */
-        newFI->orderStamp = ++newOrder;
     }
 
-    return newFI;
-}
+    newFI->orderStamp = sInStamp++;
 
-/******************************************************************************
- * @fn          nwk_QadjustOrder
- *
- * @brief       Adjusts the age of everyone in the queue newer than the frame
- *              being removed.
- *
- * input parameters
- * @param   which   - INQ or OUTQ to adjust
- * @param   stamp   - value of frame being removed
- *
- * output parameters
- *
- * @return      void
- */
-
-void nwk_QadjustOrder(uint8_t which, uint8_t stamp)
-{
-    frameInfo_t *pFI;
-    uint8_t i, num;
-    bspIState_t intState;
-
-    if (INQ == which)
-    {
-        pFI  = sInFrameQ;
-        num  = SIZE_INFRAME_Q;
-    }
-    else
-    {
-        /*    pFI  = sOutFrameQ;
-         *    num  = SIZE_OUTFRAME_Q; */
-        return;
-    }
-
-    BSP_ENTER_CRITICAL_SECTION(intState);
-
-    for (i = 0; i < num; ++i, ++pFI)
-    {
-        if ((pFI->fi_usage != FI_AVAILABLE) && (pFI->orderStamp > stamp))
-        {
-            pFI->orderStamp--;
-        }
-    }
-
-    BSP_EXIT_CRITICAL_SECTION(intState);
-
-    return;
+    return newFI;
 }
 
 /******************************************************************************
@@ -271,7 +224,7 @@ void nwk_QadjustOrder(uint8_t which, uint8_t stamp)
 
 frameInfo_t *nwk_QfindOldest(uint8_t which, rcvContext_t *rcv, uint8_t fi_usage)
 {
-    uint8_t i, oldest, num, port;
+    uint8_t i, now, age, oldestAge = 0, num, port;
     uint8_t uType, addr12Compare;
     bspIState_t intState;
     frameInfo_t *fPtr = 0, *wPtr;
@@ -282,7 +235,7 @@ frameInfo_t *nwk_QfindOldest(uint8_t which, rcvContext_t *rcv, uint8_t fi_usage)
     {
         wPtr   = sInFrameQ;
         num    = SIZE_INFRAME_Q;
-        oldest = SIZE_INFRAME_Q + 1;
+        now    = sInStamp;
     }
     else
     {
@@ -364,15 +317,23 @@ frameInfo_t *nwk_QfindOldest(uint8_t which, rcvContext_t *rcv, uint8_t fi_usage)
                     (pAddr3 && !memcmp(pAddr3, MRFI_P_SRC_ADDR(&wPtr->mrfiPkt), NET_ADDR_SIZE))
                     )
                 {
-                    if (wPtr->orderStamp < oldest)
+                    /* frames received during this scan are stamped after
+                     * 'now'. They are the newest.
+                     */
+                    age = now - wPtr->orderStamp;
+                    if (age > Q_AGE_MAX)
+                    {
+                        age = 0;
+                    }
+                    if (!fPtr || (age > oldestAge))
                     {
                         if (fPtr)
                         {
                             /* restore previous oldest one */
                             fPtr->fi_usage = uType;
                         }
-                        oldest = wPtr->orderStamp;
-                        fPtr   = wPtr;
+                        oldestAge = age;
+                        fPtr      = wPtr;
                         continue;
                     }
                     else
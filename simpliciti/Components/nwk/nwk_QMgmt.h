@@ -47,7 +47,6 @@
 void nwk_QInit(void);
 
 frameInfo_t *nwk_QfindSlot(uint8_t);
-void nwk_QadjustOrder(uint8_t, uint8_t);
 frameInfo_t *nwk_QfindOldest(uint8_t, rcvContext_t *, uint8_t);
 frameInfo_t *nwk_getQ(uint8_t);
 
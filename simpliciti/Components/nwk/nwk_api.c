@@ -88,6 +88,7 @@ uint8_t sInit_done = 0;
  * LOCAL FUNCTIONS
  */
 static uint8_t ioctlPreInitAccessIsOK(ioctlObject_t);
+static smplStatus_t initStack(uint8_t (*)(linkID_t));
 
 /******************************************************************************
  * GLOBAL VARIABLES
@@ -123,6 +124,70 @@ smplStatus_t SMPL_Init(uint8_t (*f)(linkID_t))
 {
     smplStatus_t rc;
 
+    if ((rc = initStack(f)) != SMPL_SUCCESS)
+    {
+        return rc;
+    }
+
+    /* Join. if no AP or Join fails that status is returned. */
+    rc = nwk_join();
+
+    return rc;
+}
+
+#ifdef EXTENDED_API
+/******************************************************************************
+ * @fn          SMPL_InitResume
+ *
+ * @brief       Initialize the SimpliciTI stack without a Join. The AP address
+ *              saved from an earlier Join is restored instead. The link token
+ *              from that Join must be set with the token IOCTL before this
+ *              call. A following Link shows if the AP still accepts them.
+ *
+ * input parameters
+ * @param   f      - Pointer to call back function. See SMPL_Init().
+ * @param   apAddr - Pointer to AP address saved from an earlier Join.
+ *
+ * output parameters
+ *
+ * @return   Status of operation:
+ *             SMPL_SUCCESS
+ */
+
+smplStatus_t SMPL_InitResume(uint8_t (*f)(linkID_t), addr_t *apAddr)
+{
+    smplStatus_t rc;
+
+    if ((rc = initStack(f)) != SMPL_SUCCESS)
+    {
+        return rc;
+    }
+
+    nwk_setAPAddress(apAddr);
+
+    return SMPL_SUCCESS;
+}
+#endif  /* EXTENDED_API */
+
+/******************************************************************************
+ * @fn          initStack
+ *
+ * @brief       Set up radio and network context once. Common part of
+ *              SMPL_Init() and SMPL_InitResume().
+ *
+ * input parameters
+ * @param   f  - Pointer to call back function. See SMPL_Init().
+ *
+ * output parameters
+ *
+ * @return   Status of operation:
+ *             SMPL_SUCCESS
+ */
+
+static smplStatus_t initStack(uint8_t (*f)(linkID_t))
+{
+    smplStatus_t rc;
+
     if (!sInit_done)
     {
         /* set up radio. */
@@ -157,10 +222,7 @@ smplStatus_t SMPL_Init(uint8_t (*f)(linkID_t))
     }
     sInit_done = 1;
 
-    /* Join. if no AP or Join fails that status is returned. */
-    rc = nwk_join();
-
-    return rc;
+    return SMPL_SUCCESS;
 }
 
 /******************************************************************************
@@ -53,6 +53,7 @@ smplStatus_t SMPL_Ioctl(ioctlObject_t, ioctlAction_t, void *);
 smplStatus_t SMPL_Ping(linkID_t);
 smplStatus_t SMPL_Unlink(linkID_t);
 smplStatus_t SMPL_Commission(addr_t *, uint8_t, uint8_t, linkID_t *);
+smplStatus_t SMPL_InitResume(uint8_t (*)(linkID_t), addr_t *);
 #endif  /* EXTENDED_API */
 
 #endif
@@ -401,8 +401,6 @@ smplStatus_t nwk_retrieveFrame(rcvContext_t *rcv, uint8_t *msg, uint8_t *len, ad
                 *hopCount = GET_FROM_FRAME(MRFI_P_PAYLOAD(&fPtr->mrfiPkt), F_HOP_COUNT);
             }
             /* input frame no longer needed. free it. */
-            nwk_QadjustOrder(INQ, fPtr->orderStamp);
-
             fPtr->fi_usage = FI_AVAILABLE;
             return SMPL_SUCCESS;
         }
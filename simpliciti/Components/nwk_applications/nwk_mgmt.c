@@ -261,13 +261,6 @@ static void send_poll_reply(mrfiPacket_t *frame)
 
     if (pOutFrame = nwk_getSandFFrame(frame, M_POLL_PORT_OS))
     {
-        /* We need to adjust the order in the queue in this case. Currently
-         * we know it is in the input queue and that this adjustment is safe
-         * because we're in an ISR thread. This is a fragile fix, though, and
-         * should be revisited when time permits.
-         */
-        nwk_QadjustOrder(INQ, pOutFrame->orderStamp);
-
         /* reset hop count... */
         PUT_INTO_FRAME(MRFI_P_PAYLOAD(&pOutFrame->mrfiPkt), F_HOP_COUNT, MAX_HOPS_FROM_AP);
         /* It's gonna be a forwarded frame. */
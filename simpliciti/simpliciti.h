@@ -86,7 +86,14 @@
 // Generic defines and variables
 
 // Entry point into SimpliciTI library
+#ifdef MRFI_CC430
+// Protothread state, see pt.h
+struct pt;
+
+extern unsigned char simpliciti_link(struct pt *pt);
+#else
 extern unsigned char simpliciti_link(void);
+#endif
 
 // 4 byte device address overrides device address set during compile time
 extern unsigned char simpliciti_ed_address[4];
@@ -97,6 +104,9 @@ extern unsigned char simpliciti_ed_address[4];
 // Data to send / receive
 extern unsigned char simpliciti_data[SIMPLICITI_MAX_PAYLOAD_LENGTH];
 
+// Length of data to send in TX only mode
+extern unsigned char simpliciti_payload_length;
+
 // Flag contains status information and triggers to send data or to exit SimpliciTI library
 // Control is done from outside SimpliciTI library
 extern unsigned char simpliciti_flag;
@@ -121,11 +131,22 @@ extern unsigned char rf_frequoffset;
 // ---------------------------------------------------------------
 // SimpliciTI RX only
 
+#ifdef MRFI_CC430
+// Entry point into SimpliciTI (protothread)
+extern unsigned char simpliciti_main_tx_only(struct pt *pt);
+
+// Protothread to read data from acceleration sensor or buttons and trigger sending
+extern unsigned char simpliciti_get_ed_data(struct pt *pt);
+#else
 // Entry point into SimpliciTI library
 extern void simpliciti_main_tx_only(void);
 
 // Callback function to read data from acceleration sensor or buttons and trigger sending
 extern void simpliciti_get_ed_data_callback(void);
+#endif
+
+// Callback function after packet was sent
+extern void simpliciti_sent_ed_data_callback(void);
 
 
 // ---------------------------------------------------------------
@@ -138,6 +159,9 @@ extern void simpliciti_get_ed_data_callback(void);
 #define SYNC_ED_TYPE_R2R                        (1u)
 #define SYNC_ED_TYPE_MEMORY                     (2u)
 #define SYNC_ED_TYPE_STATUS                     (3u)
+#define SYNC_ED_TYPE_ALTITUDE_SESSION           (4u)
+#define SYNC_ED_TYPE_PROFILE                    (5u)
+#define SYNC_ED_TYPE_RAM                        (6u)
 
 // Host data    (0)CMD    (1) - (18) DATA
 #define SYNC_AP_CMD_NOP                         (1u)
@@ -147,10 +171,27 @@ extern void simpliciti_get_ed_data_callback(void);
 #define SYNC_AP_CMD_GET_MEMORY_BLOCKS_MODE_2    (5u)
 #define SYNC_AP_CMD_ERASE_MEMORY                (6u)
 #define SYNC_AP_CMD_EXIT                        (7u)
+#define SYNC_AP_CMD_GET_ALTITUDE_SESSION        (8u)
+#define SYNC_AP_CMD_GET_PROFILE                 (9u)
+#define SYNC_AP_CMD_GET_RAM                     (10u)
+#define SYNC_AP_CMD_GET_MEMORY_WINDOW           (12u)
+#define SYNC_AP_CMD_ACK_MEMORY_WINDOW           (13u)
+#define SYNC_AP_CMD_LISTEN                      (14u)
 
+// Maximum number of packets in a windowed memory transfer (one bit each in ACK bitmap)
+#define SYNC_WINDOW_MAX                         (16u)
 
+// Time to listen for ACK or next command after a windowed transfer (ms)
+#define SYNC_WINDOW_TIMEOUT                     (20u)
+
+
+#ifdef MRFI_CC430
+// Entry point into SimpliciTI (protothread)
+extern unsigned char simpliciti_main_sync(struct pt *pt);
+#else
 // Entry point into SimpliciTI library
 extern void simpliciti_main_sync(void);
+#endif
 
 // Callback function to decode access point command
 extern void simpliciti_sync_decode_ap_cmd_callback(void);
@@ -161,3 +202,10 @@ extern void simpliciti_sync_get_data_callback(unsigned int index);
 // Send reply packets (>0), 0=no need to reply
 extern unsigned char simpliciti_reply_count;
 
+// 1 = send reply packets back-to-back and keep listening for ACK or next command (windowed
+// transfer), 0 = send reply packets with delay and go back to sleep
+extern unsigned char simpliciti_reply_window;
+
+// Wake-on-radio interval (ms) requested by host, 0 = keep sending ready-to-receive packets
+extern unsigned int simpliciti_listen_interval;
+